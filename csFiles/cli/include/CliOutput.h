@@ -0,0 +1,65 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CLIOUTPUT_H
+#define CLIOUTPUT_H
+
+#include <QtCore/QString>
+
+#include "MatchJob.h"
+
+enum class OutputFormat {
+  Grep = 0,
+  Json
+};
+
+class CliOutput {
+public:
+  CliOutput(const OutputFormat format, const bool context);
+  ~CliOutput();
+
+  void printPath(const QString& path);
+  void printResult(const MatchResult& result);
+
+private:
+  CliOutput() = delete;
+
+  void printJsonLine(const MatchResult& result, const QString& filename, const int i);
+  void printGrepLine(const MatchResult& result, const QByteArray& filename, const int i);
+  void write(const QByteArray& line);
+
+  bool _context{false};
+  OutputFormat _format{OutputFormat::Grep};
+  int _lastno{0}; // Number of the last line printed
+  bool _printed{false};
+};
+
+#endif // CLIOUTPUT_H
@@ -0,0 +1,135 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include "CliOutput.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+CliOutput::CliOutput(const OutputFormat format, const bool context)
+  : _context{context}
+  , _format{format}
+{
+}
+
+CliOutput::~CliOutput()
+{
+  std::fflush(stdout);
+}
+
+void CliOutput::printPath(const QString& path)
+{
+  if( _format == OutputFormat::Json ) {
+    QJsonObject obj;
+    obj.insert(QStringLiteral("type"), QStringLiteral("path"));
+    obj.insert(QStringLiteral("path"), path);
+    write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+  } else {
+    write(path.toUtf8());
+  }
+}
+
+void CliOutput::printResult(const MatchResult& result)
+{
+  const QString filename = result.filename();
+  const QByteArray filenameUtf8 = filename.toUtf8();
+
+  for(int i = 0; i < result.lineCount(); i++) {
+    if( _format == OutputFormat::Json ) {
+      printJsonLine(result, filename, i);
+      continue;
+    }
+
+    // NOTE: Like grep, separate non-contiguous groups if context is shown.
+    const int lineno = result.lineNumber(i);
+    if( _context  &&  _printed  &&  (i == 0  ||  lineno > _lastno + 1) ) {
+      write(QByteArrayLiteral("--"));
+    }
+    printGrepLine(result, filenameUtf8, i);
+    _lastno  = lineno;
+    _printed = true;
+  }
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void CliOutput::printJsonLine(const MatchResult& result, const QString& filename, const int i)
+{
+  const bool is_context = result.lineIsContext(i);
+
+  QJsonObject obj;
+  obj.insert(QStringLiteral("type"), is_context
+             ? QStringLiteral("context")
+             : QStringLiteral("match"));
+  obj.insert(QStringLiteral("path"), filename);
+  obj.insert(QStringLiteral("line"), result.lineNumber(i));
+  obj.insert(QStringLiteral("text"), result.lineText(i));
+  if( !is_context ) {
+    QJsonArray matches;
+    const MatchView view = result.lineMatches(i);
+    for(const Match *m = view.first; m < view.second; ++m) {
+      QJsonObject match;
+      match.insert(QStringLiteral("start"), m->first);
+      match.insert(QStringLiteral("length"), m->second);
+      matches.push_back(match);
+    }
+    obj.insert(QStringLiteral("matches"), matches);
+  }
+
+  write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+}
+
+void CliOutput::printGrepLine(const MatchResult& result, const QByteArray& filename, const int i)
+{
+  const char sep = result.lineIsContext(i)
+      ? '-'
+      : ':';
+
+  QByteArray line = filename;
+  line.append(sep);
+  line.append(QByteArray::number(result.lineNumber(i)));
+  line.append(sep);
+  const TextLine text = result.lineView(i);
+  line.append(text.first, static_cast<int>(diff(text)));
+
+  write(line);
+}
+
+void CliOutput::write(const QByteArray& line)
+{
+  std::fwrite(line.constData(), 1, static_cast<std::size_t>(line.size()), stdout);
+  std::fputc('\n', stdout);
+}
@@ -0,0 +1,608 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <limits>
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+
+#include "BloomCache.h"
+#include "CliOutput.h"
+#include "ExtensionFilter.h"
+#include "FilenameFilter.h"
+#include "FindGrep.h"
+#include "FindJob.h"
+#include "MatchJob.h"
+#include "MatchLog.h"
+#include "MetadataFilter.h"
+#include "PathFilter.h"
+#include "PatternLiterals.h"
+#include "TrigramIndex.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr int kExitMatch   = 0;
+constexpr int kExitNoMatch = 1;
+constexpr int kExitError   = 2;
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  namespace opt {
+
+    const QCommandLineOption after(QStringList{QStringLiteral("A"), QStringLiteral("after-context")},
+                                   QStringLiteral("Print <num> lines of context after each match."),
+                                   QStringLiteral("num"));
+    const QCommandLineOption all(QStringList{QStringLiteral("a"), QStringLiteral("all")},
+                                 QStringLiteral("Find all matches of a line."));
+    const QCommandLineOption before(QStringList{QStringLiteral("B"), QStringLiteral("before-context")},
+                                    QStringLiteral("Print <num> lines of context before each match."),
+                                    QStringLiteral("num"));
+    const QCommandLineOption bloom(QStringLiteral("bloom"),
+                                   QStringLiteral("Skip files proven not to match by filters cached in <dir>; new filters are cached while matching."),
+                                   QStringLiteral("dir"));
+    const QCommandLineOption changedBefore(QStringLiteral("changed-before"),
+                                           QStringLiteral("Accept entries last modified more than <age> ago (s, m, h, d; default: d)."),
+                                           QStringLiteral("age"));
+    const QCommandLineOption changedWithin(QStringLiteral("changed-within"),
+                                           QStringLiteral("Accept entries last modified within <age> (s, m, h, d; default: d)."),
+                                           QStringLiteral("age"));
+    const QCommandLineOption completeSuffix(QStringLiteral("complete-suffix"),
+                                            QStringLiteral("Match extensions against the complete suffix."));
+    const QCommandLineOption context(QStringList{QStringLiteral("C"), QStringLiteral("context")},
+                                     QStringLiteral("Print <num> lines of context around each match."),
+                                     QStringLiteral("num"));
+    const QCommandLineOption ext(QStringLiteral("ext"),
+                                 QStringLiteral("Accept extensions <list>."),
+                                 QStringLiteral("list"));
+    const QCommandLineOption excludeExt(QStringLiteral("exclude-ext"),
+                                        QStringLiteral("Reject extensions <list>."),
+                                        QStringLiteral("list"));
+    const QCommandLineOption excludeName(QStringLiteral("exclude-name"),
+                                         QStringLiteral("Reject file names matching any wildcard of <list>."),
+                                         QStringLiteral("list"));
+    const QCommandLineOption excludePath(QStringLiteral("exclude-path"),
+                                         QStringLiteral("Reject paths containing any of <list>."),
+                                         QStringLiteral("list"));
+    const QCommandLineOption follow(QStringList{QStringLiteral("L"), QStringLiteral("follow")},
+                                    QStringLiteral("Follow symbolic links."));
+    const QCommandLineOption ignoreCase(QStringList{QStringLiteral("i"), QStringLiteral("ignore-case")},
+                                        QStringLiteral("Ignore case."));
+    const QCommandLineOption ignoreFiles(QStringLiteral("ignore-files"),
+                                         QStringLiteral("Honour .gitignore, .ignore and global exclude files."));
+    const QCommandLineOption index(QStringLiteral("index"),
+                                   QStringLiteral("Match only candidates of a trigram index of the directory kept up to date in <file>."),
+                                   QStringLiteral("file"));
+    const QCommandLineOption json(QStringLiteral("json"),
+                                  QStringLiteral("Print results as JSON Lines."));
+    const QCommandLineOption maxSize(QStringLiteral("max-size"),
+                                     QStringLiteral("Accept files of at most <size> bytes (K, M, G)."),
+                                     QStringLiteral("size"));
+    const QCommandLineOption minSize(QStringLiteral("min-size"),
+                                     QStringLiteral("Accept files of at least <size> bytes (K, M, G)."),
+                                     QStringLiteral("size"));
+    const QCommandLineOption name(QStringLiteral("name"),
+                                  QStringLiteral("Accept file names matching any wildcard of <list>."),
+                                  QStringLiteral("list"));
+    const QCommandLineOption noMessages(QStringList{QStringLiteral("s"), QStringLiteral("no-messages")},
+                                        QStringLiteral("Suppress warnings and errors about files."));
+    const QCommandLineOption noRecurse(QStringLiteral("no-recurse"),
+                                       QStringLiteral("Do not descend into subdirectories."));
+    const QCommandLineOption path(QStringLiteral("path"),
+                                  QStringLiteral("Accept paths containing any of <list>."),
+                                  QStringLiteral("list"));
+    const QCommandLineOption perm(QStringLiteral("perm"),
+                                  QStringLiteral("Accept entries with all permission bits of octal <mode> set."),
+                                  QStringLiteral("mode"));
+    const QCommandLineOption recursive(QStringList{QStringLiteral("r"), QStringLiteral("recursive")},
+                                       QStringLiteral("Search directories recursively."));
+    const QCommandLineOption regexp(QStringList{QStringLiteral("E"), QStringLiteral("regexp")},
+                                    QStringLiteral("Interpret <pattern> as a regular expression."));
+    const QCommandLineOption snapshot(QStringLiteral("snapshot"),
+                                      QStringLiteral("Walk a snapshot of the tree kept up to date in <file>; not used with -L, --xdev or metadata filters."),
+                                      QStringLiteral("file"));
+    const QCommandLineOption stats(QStringLiteral("stats"),
+                                   QStringLiteral("Print statistics to stderr when finished."));
+    const QCommandLineOption stream(QStringLiteral("stream"),
+                                    QStringLiteral("Search files while directories are still read; results are unordered."));
+    const QCommandLineOption type(QStringLiteral("type"),
+                                  QStringLiteral("List only files (f), directories (d) or symbolic links (l)."),
+                                  QStringLiteral("f|d|l"));
+    const QCommandLineOption utf8(QStringList{QStringLiteral("u"), QStringLiteral("utf8")},
+                                  QStringLiteral("Match UTF-8 encoded text."));
+    const QCommandLineOption xdev(QStringLiteral("xdev"),
+                                  QStringLiteral("Do not descend into directories on other file systems."));
+
+  } // namespace opt
+
+  void printError(const QString& error)
+  {
+    std::fprintf(stderr, "ERROR: %s\n", error.toLocal8Bit().constData());
+  }
+
+  // NOTE: Ages are given relative to now; a bare number counts days.
+  int64_t parseAge(const QString& value, bool *ok)
+  {
+    *ok = false;
+
+    QString number = value.trimmed();
+    int64_t unit = INT64_C(24)*60*60*1000; // [ms]
+    if( !number.isEmpty()  &&  number.at(number.size() - 1).isLetter() ) {
+      const QChar c = number.at(number.size() - 1).toLower();
+      if(        c == QLatin1Char('s') ) {
+        unit = INT64_C(1000);
+      } else if( c == QLatin1Char('m') ) {
+        unit = INT64_C(60)*1000;
+      } else if( c == QLatin1Char('h') ) {
+        unit = INT64_C(60)*60*1000;
+      } else if( c != QLatin1Char('d') ) {
+        return 0;
+      }
+      number.chop(1);
+    }
+
+    const qlonglong age = number.toLongLong(ok);
+    if( !*ok  ||  age < 0  ||  age > std::numeric_limits<int64_t>::max()/unit ) {
+      *ok = false;
+      return 0;
+    }
+    return QDateTime::currentMSecsSinceEpoch() - age*unit;
+  }
+
+  int64_t parseSize(const QString& value, bool *ok)
+  {
+    *ok = false;
+
+    QString number = value.trimmed();
+    int64_t unit = 1;
+    if( !number.isEmpty()  &&  number.at(number.size() - 1).isLetter() ) {
+      const QChar c = number.at(number.size() - 1).toUpper();
+      if(        c == QLatin1Char('K') ) {
+        unit = INT64_C(1024);
+      } else if( c == QLatin1Char('M') ) {
+        unit = INT64_C(1024)*1024;
+      } else if( c == QLatin1Char('G') ) {
+        unit = INT64_C(1024)*1024*1024;
+      } else {
+        return -1;
+      }
+      number.chop(1);
+    }
+
+    const qlonglong size = number.toLongLong(ok);
+    if( !*ok  ||  size < 0  ||  size > std::numeric_limits<int64_t>::max()/unit ) {
+      *ok = false;
+      return -1;
+    }
+    return size*unit;
+  }
+
+  void addFilterOptions(QCommandLineParser& parser)
+  {
+    parser.addOption(opt::changedBefore);
+    parser.addOption(opt::changedWithin);
+    parser.addOption(opt::completeSuffix);
+    parser.addOption(opt::excludeExt);
+    parser.addOption(opt::excludeName);
+    parser.addOption(opt::excludePath);
+    parser.addOption(opt::ext);
+    parser.addOption(opt::follow);
+    parser.addOption(opt::ignoreFiles);
+    parser.addOption(opt::maxSize);
+    parser.addOption(opt::minSize);
+    parser.addOption(opt::name);
+    parser.addOption(opt::path);
+    parser.addOption(opt::perm);
+    parser.addOption(opt::xdev);
+  }
+
+  bool addMetadataFilter(IFindFilters& filters, const QCommandLineParser& parser,
+                         const FindType type)
+  {
+    MetadataCriteria criteria;
+    criteria.type = type;
+
+    bool ok = true;
+    if( ok  &&  parser.isSet(opt::minSize) ) {
+      criteria.minSize = parseSize(parser.value(opt::minSize), &ok);
+    }
+    if( ok  &&  parser.isSet(opt::maxSize) ) {
+      criteria.maxSize = parseSize(parser.value(opt::maxSize), &ok);
+    }
+    if( ok  &&  parser.isSet(opt::changedWithin) ) {
+      criteria.modifiedAfter = parseAge(parser.value(opt::changedWithin), &ok);
+    }
+    if( ok  &&  parser.isSet(opt::changedBefore) ) {
+      criteria.modifiedBefore = parseAge(parser.value(opt::changedBefore), &ok);
+    }
+    if( ok  &&  parser.isSet(opt::perm) ) {
+      criteria.permissions = parser.value(opt::perm).toUInt(&ok, 8);
+    }
+    if( !ok ) {
+      printError(QStringLiteral("Invalid metadata filter!"));
+      return false;
+    }
+
+    filters.push_back(MetadataFilter::create(criteria));
+
+    return true;
+  }
+
+  bool addFilters(IFindFilters& filters, const QCommandLineParser& parser,
+                  const FindType type = FindType::Unknown)
+  {
+    const bool complete = parser.isSet(opt::completeSuffix);
+
+    filters.push_back(PathFilter::create(parser.value(opt::path), false));
+    filters.push_back(PathFilter::create(parser.value(opt::excludePath), true));
+    filters.push_back(ExtensionFilter::create(parser.value(opt::ext), false, complete));
+    filters.push_back(ExtensionFilter::create(parser.value(opt::excludeExt), true, complete));
+    filters.push_back(FilenameFilter::create(parser.value(opt::name), false));
+    filters.push_back(FilenameFilter::create(parser.value(opt::excludeName), true));
+
+    return addMetadataFilter(filters, parser, type);
+  }
+
+  bool makeGrepFindJob(FindJob& job, const QString& rootPath, const QCommandLineParser& parser,
+                       const IMatcher& matcher)
+  {
+    FindFlags flags{FindFlag::NoFlags};
+    flags.set(FindFlag::Files, true);
+    flags.set(FindFlag::Subdirectories, true);
+    flags.set(FindFlag::FollowSymlinks, parser.isSet(opt::follow));
+    flags.set(FindFlag::IgnoreFiles, parser.isSet(opt::ignoreFiles));
+    flags.set(FindFlag::SameFileSystem, parser.isSet(opt::xdev));
+
+    job = FindJob(rootPath, flags);
+
+    if( !addFilters(job.filters, parser) ) {
+      return false;
+    }
+
+    // NOTE: Without an index, every file is a candidate.
+    if( parser.isSet(opt::index) ) {
+      const TrigramIndexPtr index =
+          TrigramIndex::update(parser.value(opt::index), QDir(rootPath).absolutePath().toStdString());
+      if( !index ) {
+        printError(QStringLiteral("%1: Unable to index directory!").arg(rootPath));
+      }
+      job.filters.push_back(TrigramFilter::create(index, requiredLiterals(matcher.pattern(), matcher.flags())));
+    }
+
+    return true;
+  }
+
+  int contextValue(const QCommandLineParser& parser, const QCommandLineOption& option)
+  {
+    const QCommandLineOption& o = parser.isSet(option)
+        ? option
+        : opt::context;
+    return qMax<int>(0, parser.value(o).toInt());
+  }
+
+  void printLog(const MatchLog::Level level, const std::string& message)
+  {
+    std::fprintf(stderr, "%s: %s\n",
+                 level == MatchLog::Level::Error ? "ERROR" : "WARNING",
+                 QString::fromStdString(message).toLocal8Bit().constData());
+  }
+
+  void printStatistics(const FindStatistics& stats)
+  {
+    std::fprintf(stderr, "directories: %llu\nentries: %llu\nrepeats: %llu\n",
+                 static_cast<unsigned long long>(stats.directories),
+                 static_cast<unsigned long long>(stats.entries),
+                 static_cast<unsigned long long>(stats.repeats));
+    for(const FilterStatistics& filter : stats.filters) {
+      if( !filter.active ) {
+        continue;
+      }
+      std::fprintf(stderr, "filter %s (%s): calls: %llu, rejects: %llu, prunes: %llu, cost: %.1f ns\n",
+                   filter.name, filter.reject ? "reject" : "accept",
+                   static_cast<unsigned long long>(filter.calls),
+                   static_cast<unsigned long long>(filter.rejects),
+                   static_cast<unsigned long long>(filter.prunes),
+                   filter.cost());
+    }
+  }
+
+  void printStatistics(const MatchLog::Statistics& stats)
+  {
+    std::fprintf(stderr, "files: %llu\nbytes: %llu\nwarnings: %llu\nerrors: %llu\nsuppressed: %llu\n",
+                 static_cast<unsigned long long>(stats.files),
+                 static_cast<unsigned long long>(stats.bytes),
+                 static_cast<unsigned long long>(stats.warnings),
+                 static_cast<unsigned long long>(stats.errors),
+                 static_cast<unsigned long long>(stats.suppressed));
+  }
+
+  IMatcherPtr makeMatcher(const QString& pattern, const QCommandLineParser& parser)
+  {
+    IMatcherPtr result = createDefaultMatcher();
+    if( !result ) {
+      printError(QStringLiteral("Creation of matcher failed!"));
+      return IMatcherPtr();
+    }
+
+    MatchFlags flags{MatchFlag::NoFlags};
+    {
+      flags.set(MatchFlag::CaseInsensitive, parser.isSet(opt::ignoreCase));
+      flags.set(MatchFlag::FindAll, parser.isSet(opt::all));
+      flags.set(MatchFlag::RegExp, parser.isSet(opt::regexp));
+      flags.set(MatchFlag::Utf8, parser.isSet(opt::utf8));
+    }
+    result->setFlags(flags);
+
+    if( !result->compile(pattern.toStdString()) ) {
+      printError(QString::fromStdString(result->error()));
+      return IMatcherPtr();
+    }
+
+    return result;
+  }
+
+  int runFind(QCoreApplication& app, QCommandLineParser& parser)
+  {
+    parser.clearPositionalArguments();
+    parser.addPositionalArgument(QStringLiteral("find"), QStringLiteral("List directory entries."));
+    parser.addPositionalArgument(QStringLiteral("directory"), QStringLiteral("Root directory."));
+    addFilterOptions(parser);
+    parser.addOption(opt::json);
+    parser.addOption(opt::noRecurse);
+    parser.addOption(opt::snapshot);
+    parser.addOption(opt::stats);
+    parser.addOption(opt::type);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if( args.size() != 2 ) {
+      parser.showHelp(kExitError);
+    }
+
+    FindFlags flags{FindFlag::NoFlags};
+    flags.set(FindFlag::Directories, parser.value(opt::type) == QStringLiteral("d"));
+    flags.set(FindFlag::Files, parser.value(opt::type) == QStringLiteral("f"));
+    flags.set(FindFlag::FollowSymlinks, parser.isSet(opt::follow));
+    flags.set(FindFlag::IgnoreFiles, parser.isSet(opt::ignoreFiles));
+    flags.set(FindFlag::SameFileSystem, parser.isSet(opt::xdev));
+    flags.set(FindFlag::Subdirectories, !parser.isSet(opt::noRecurse));
+
+    const FindType type = parser.value(opt::type) == QStringLiteral("l")
+        ? FindType::SymLink
+        : FindType::Unknown;
+
+    FindJob job(args.at(1), flags);
+    if( !addFilters(job.filters, parser, type) ) {
+      return kExitError;
+    }
+    job.snapshotFile = parser.value(opt::snapshot);
+
+    CliOutput output(parser.isSet(opt::json)
+                     ? OutputFormat::Json
+                     : OutputFormat::Grep, false);
+    FindStatistics stats;
+    const QStringList results = executeFind(job, &stats);
+    for(const QString& path : results) {
+      output.printPath(path);
+    }
+
+    if( parser.isSet(opt::stats) ) {
+      printStatistics(stats);
+    }
+
+    return kExitMatch;
+  }
+
+  int runGrep(QCoreApplication& app, QCommandLineParser& parser)
+  {
+    parser.clearPositionalArguments();
+    parser.addPositionalArgument(QStringLiteral("grep"), QStringLiteral("Search files for a pattern."));
+    parser.addPositionalArgument(QStringLiteral("pattern"), QStringLiteral("Search pattern."));
+    parser.addPositionalArgument(QStringLiteral("paths"), QStringLiteral("Files or directories."),
+                                 QStringLiteral("<paths...>"));
+    addFilterOptions(parser);
+    parser.addOption(opt::after);
+    parser.addOption(opt::all);
+    parser.addOption(opt::before);
+    parser.addOption(opt::bloom);
+    parser.addOption(opt::context);
+    parser.addOption(opt::ignoreCase);
+    parser.addOption(opt::index);
+    parser.addOption(opt::json);
+    parser.addOption(opt::noMessages);
+    parser.addOption(opt::recursive);
+    parser.addOption(opt::regexp);
+    parser.addOption(opt::stats);
+    parser.addOption(opt::stream);
+    parser.addOption(opt::utf8);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if( args.size() < 3 ) {
+      parser.showHelp(kExitError);
+    }
+
+    IMatcherPtr matcher = makeMatcher(args.at(1), parser);
+    if( !matcher ) {
+      return kExitError;
+    }
+
+    // (1) Collect files /////////////////////////////////////////////////////
+
+    // NOTE: When streaming, directories are searched while they are read (cf. (4)).
+    const bool stream = parser.isSet(opt::stream);
+
+    QStringList files;
+    QStringList dirs;
+    for(int i = 2; i < args.size(); i++) {
+      const QFileInfo info(args.at(i));
+      if( info.isDir() ) {
+        if( !parser.isSet(opt::recursive) ) {
+          printError(QStringLiteral("%1: Is a directory!").arg(args.at(i)));
+          continue;
+        }
+
+        if( stream ) {
+          dirs.push_back(info.filePath());
+          continue;
+        }
+
+        FindJob job;
+        if( !makeGrepFindJob(job, info.filePath(), parser, *matcher) ) {
+          return kExitError;
+        }
+
+        QStringList found = executeFind(job);
+        found.sort();
+        files.append(found);
+      } else {
+        files.push_back(info.filePath());
+      }
+    }
+
+    // (2) Create jobs ///////////////////////////////////////////////////////
+
+    const int after  = contextValue(parser, opt::after);
+    const int before = contextValue(parser, opt::before);
+
+    MatchLog log(parser.isSet(opt::noMessages)
+                 ? MatchLog::Sink()
+                 : MatchLog::Sink(printLog));
+
+    const BloomCachePtr bloom = parser.isSet(opt::bloom)
+        ? BloomCache::create(parser.value(opt::bloom), requiredLiterals(matcher->pattern(), matcher->flags()))
+        : BloomCachePtr();
+
+    PathStore paths;
+
+    MatchJobs jobs;
+    jobs.reserve(static_cast<MatchJobs::size_type>(files.size()));
+    for(const QString& filename : files) {
+      MatchJob job{&paths, paths.insert(filename)};
+      job.contextAfter  = after;
+      job.contextBefore = before;
+      job.log = &log;
+      job.bloom = bloom.get();
+      job.matcher = matcher->clone();
+      jobs.push_back(std::move(job));
+    }
+
+    // (3) Match files; results are printed in order as they arrive //////////
+
+    CliOutput output(parser.isSet(opt::json)
+                     ? OutputFormat::Json
+                     : OutputFormat::Grep, after > 0  ||  before > 0);
+
+    QFuture<MatchResultPtr> future = QtConcurrent::mapped(jobs.cbegin(), jobs.cend(), executeJob);
+
+    bool have_match = false;
+    for(int i = 0; i < static_cast<int>(jobs.size()); i++) {
+      const MatchResultPtr result = future.resultAt(i);
+      if( !result  ||  result->isEmpty() ) {
+        continue;
+      }
+      output.printResult(*result);
+      have_match = true;
+    }
+
+    // (4) Match files of directories as they are found //////////////////////
+
+    if( !dirs.isEmpty() ) {
+      MatchJob templ;
+      templ.contextAfter  = after;
+      templ.contextBefore = before;
+      templ.log = &log;
+      templ.bloom = bloom.get();
+      templ.matcher = matcher->clone();
+
+      for(const QString& dir : dirs) {
+        FindJob job;
+        if( !makeGrepFindJob(job, dir, parser, *matcher) ) {
+          return kExitError;
+        }
+
+        executeFindGrep(job, templ, &paths, [&](const MatchResultPtr& result) -> void {
+          output.printResult(*result);
+          have_match = true;
+        });
+      }
+    }
+
+    const MatchLog::Statistics stats = log.statistics();
+    if( parser.isSet(opt::stats) ) {
+      printStatistics(stats);
+    } else if( stats.suppressed > 0  &&  !parser.isSet(opt::noMessages) ) {
+      printError(QStringLiteral("%1 more messages suppressed!").arg(qulonglong(stats.suppressed)));
+    }
+
+    return have_match
+        ? kExitMatch
+        : kExitNoMatch;
+  }
+
+} // namespace priv
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName(QStringLiteral("csfiles-cli"));
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(QStringLiteral("Command line frontend of csFiles."));
+  parser.addHelpOption();
+  parser.addPositionalArgument(QStringLiteral("command"), QStringLiteral("find | grep"));
+
+  parser.parse(app.arguments());
+
+  const QStringList args = parser.positionalArguments();
+  const QString command = !args.isEmpty()
+      ? args.front()
+      : QString();
+
+  if(        command == QStringLiteral("find") ) {
+    return priv::runFind(app, parser);
+  } else if( command == QStringLiteral("grep") ) {
+    return priv::runGrep(app, parser);
+  }
+
+  parser.process(app);
+  parser.showHelp(kExitError);
+
+  return kExitError;
+}
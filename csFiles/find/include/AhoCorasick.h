@@ -29,66 +29,47 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#ifndef MATCHJOB_H
-#define MATCHJOB_H
+#ifndef AHOCORASICK_H
+#define AHOCORASICK_H
 
-#include <QtCore/QList>
-#include <QtCore/QString>
-#include <QtCore/QVector>
+#include <cstdint>
 
-#include "IMatcher.h"
+#include <string>
+#include <string_view>
+#include <vector>
 
-class csILogger;
+// NOTE: Aho-Corasick automaton compiled into a complete DFA over bytes;
+//       a single pass over a text tests for the occurrence of any pattern.
+//       Case insensitive automata fold ASCII letters.
 
-////// MatchJob //////////////////////////////////////////////////////////////
+class AhoCorasick {
+public:
+  AhoCorasick() = default;
+  AhoCorasick(const std::vector<std::string>& patterns, const bool caseInsensitive);
+  ~AhoCorasick() = default;
 
-struct MatchJob {
-  MatchJob() noexcept = default;
-  MatchJob(const MatchJob& other) noexcept;
-  MatchJob(const QString& _filename) noexcept;
+  AhoCorasick(const AhoCorasick&) = default;
+  AhoCorasick& operator=(const AhoCorasick&) = default;
 
-  QString filename{};
-  const csILogger *logger{nullptr};
-  IMatcherPtr matcher{};
-};
-
-using MatchJobs = QList<MatchJob>;
-
-////// MatchedLine ///////////////////////////////////////////////////////////
-
-struct MatchedLine {
-  MatchedLine() noexcept = default;
-
-  bool assign(const TextLine& text, const int lineno, const MatchList& matches);
-
-  QString      text{};
-  int          number{};
-  QVector<int> start{};
-  QVector<int> length{};
-};
-
-bool operator<(const MatchedLine& a, const MatchedLine& b);
-
-using MatchedLines = QList<MatchedLine>;
-
-////// MatchResult ///////////////////////////////////////////////////////////
-
-struct MatchResult {
-  MatchResult() noexcept = default;
-  MatchResult(const MatchJob& job) noexcept;
+  AhoCorasick(AhoCorasick&&) = default;
+  AhoCorasick& operator=(AhoCorasick&&) = default;
 
+  bool containsAny(const std::string_view& text) const;
   bool isEmpty() const;
+  int stateCount() const;
 
-  QString      filename{};
-  MatchedLines lines{};
-};
-
-bool operator<(const MatchResult& a, const MatchResult& b);
+private:
+  using State = int32_t;
 
-using MatchResults = QList<MatchResult>;
+  static constexpr int kAlphabet = 256;
 
-////// Functions /////////////////////////////////////////////////////////////
+  inline State next(const State s, const unsigned char c) const
+  {
+    return _next[std::size_t(s)*kAlphabet + c];
+  }
 
-MatchResult executeJob(const MatchJob& job);
+  std::vector<State> _next{};
+  std::vector<bool> _final{};
+};
 
-#endif // MATCHJOB_H
+#endif // AHOCORASICK_H
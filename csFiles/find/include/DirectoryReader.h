@@ -0,0 +1,82 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef DIRECTORYREADER_H
+#define DIRECTORYREADER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QtCore/QtGlobal>
+
+#include "FindEntry.h"
+#include "VisitedDirectories.h"
+
+class QDirIterator;
+
+// NOTE: Lists the entries of a single directory into a FindEntry;
+//       '.', '..' and hidden entries are skipped.
+//       On Linux, entries are read with getdents64() and classified by d_type;
+//       nothing is stat()'ed until a FindEntry's metadata is requested.
+
+class DirectoryReader {
+public:
+  DirectoryReader();
+  ~DirectoryReader();
+
+  void close();
+  bool identity(DirectoryIdentity& id) const;
+  bool isOpen() const;
+  bool next(FindEntry& entry);
+  bool open(const std::string& dirPath, FindEntry& entry);
+
+private:
+  DirectoryReader(const DirectoryReader&) = delete;
+  DirectoryReader& operator=(const DirectoryReader&) = delete;
+
+  DirectoryReader(DirectoryReader&&) = delete;
+  DirectoryReader& operator=(DirectoryReader&&) = delete;
+
+#ifdef Q_OS_LINUX
+  bool fill();
+
+  std::vector<char> _buffer;
+  int _fd{-1};
+  long _pos{0};
+  long _end{0};
+#else
+  std::string _path;
+  std::unique_ptr<QDirIterator> _iter;
+#endif
+};
+
+#endif // DIRECTORYREADER_H
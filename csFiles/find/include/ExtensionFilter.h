@@ -32,27 +32,31 @@
 #ifndef EXTENSIONFILTER_H
 #define EXTENSIONFILTER_H
 
-#include <QtCore/QStringList>
+#include <QtCore/QString>
 
 #include "IFindFilter.h"
+#include "KeyMap.h"
 
 class ExtensionFilter : public IFindFilter {
 public:
   ~ExtensionFilter();
 
+  IFindFilterPtr clone() const;
+  const char *name() const;
+
   static IFindFilterPtr create(const QString& extensions, const bool reject,
                                const bool complete = false);
 
 protected:
   bool isActive() const;
-  bool isMatch(const QFileInfo& info) const;
+  bool isMatch(const FindEntry& entry) const;
 
 private:
   ExtensionFilter() = delete;
   ExtensionFilter(const QString& extensions, const bool reject, const bool complete);
 
   bool _complete{false};
-  QStringList _extensions;
+  KeyMap _extensions{}; // ASCII case-folded, UTF-8
 };
 
 #endif // EXTENSIONFILTER_H
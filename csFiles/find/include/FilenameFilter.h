@@ -32,26 +32,29 @@
 #ifndef FILENAMEFILTER_H
 #define FILENAMEFILTER_H
 
-#include <QtCore/QRegExp>
+#include <QtCore/QString>
 
+#include "GlobSet.h"
 #include "IFindFilter.h"
 
 class FilenameFilter : public IFindFilter {
 public:
   ~FilenameFilter();
 
+  IFindFilterPtr clone() const;
+  const char *name() const;
+
   static IFindFilterPtr create(const QString& pattern, const bool reject);
 
 protected:
   bool isActive() const;
-  bool isMatch(const QFileInfo& info) const;
+  bool isMatch(const FindEntry& entry) const;
 
 private:
   FilenameFilter() = delete;
   FilenameFilter(const QString& pattern, const bool reject);
 
-  QString _pattern;
-  QRegExp _regexp;
+  GlobSet _globs{true};
 };
 
 #endif // FILENAMEFILTER_H
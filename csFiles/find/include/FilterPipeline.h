@@ -0,0 +1,95 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef FILTERPIPELINE_H
+#define FILTERPIPELINE_H
+
+#include <cstdint>
+
+#include <vector>
+
+#include "IFindFilter.h"
+
+using IFindFilters = std::vector<IFindFilterPtr>;
+
+struct FilterStatistics {
+  const char *name{nullptr};
+  bool reject{false};
+  bool active{false};
+  uint64_t calls{0};
+  uint64_t rejects{0};
+  uint64_t prunes{0};
+  uint64_t samples{0};
+  uint64_t sampledNs{0};
+
+  double cost() const;        // [ns] per call
+  double selectivity() const; // Probability of a reject
+
+  FilterStatistics& operator+=(const FilterStatistics& other);
+};
+
+using FilterStatisticsList = std::vector<FilterStatistics>;
+
+// NOTE: A FilterPipeline evaluates (private clones of) active filters only;
+//       as an entry is filtered if any filter rejects it, the filters are
+//       periodically reordered by their measured cost per reject.
+
+class FilterPipeline {
+public:
+  FilterPipeline(const IFindFilters& filters);
+  ~FilterPipeline();
+
+  bool filtered(const FindEntry& entry);
+  bool isEmpty() const;
+  bool pruned(const FindEntry& dir);
+  FilterStatisticsList statistics() const; // In order of the original filters
+
+private:
+  FilterPipeline(const FilterPipeline&) = delete;
+  FilterPipeline& operator=(const FilterPipeline&) = delete;
+
+  FilterPipeline(FilterPipeline&&) = delete;
+  FilterPipeline& operator=(FilterPipeline&&) = delete;
+
+  struct Stage {
+    IFindFilterPtr filter;
+    int index;
+    FilterStatistics stats;
+  };
+
+  void reorder();
+
+  uint64_t _numCalls{0};
+  int _numFilters{0};
+  std::vector<Stage> _stages;
+};
+
+#endif // FILTERPIPELINE_H
@@ -0,0 +1,132 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef FINDENTRY_H
+#define FINDENTRY_H
+
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+
+#include <QtCore/QString>
+
+enum class FindType : unsigned char {
+  Unknown = 0,
+  Directory,
+  File,
+  SymLink,
+  Other
+};
+
+struct FindMetadata {
+  enum Field : unsigned {
+    Type         = 0x01,
+    Mode         = 0x02, // Including type
+    Identity     = 0x04, // Device & inode
+    Size         = 0x08,
+    LastModified = 0x10,
+    All          = 0x1F
+  };
+
+  uint64_t device{0};
+  uint64_t inode{0};
+  uint32_t mode{0};
+  uint64_t size{0};
+  int64_t  lastModified{0}; // [ms] since epoch
+};
+
+// NOTE: A FindEntry is reused by the walker for every entry of a directory;
+//       paths are UTF-8 encoded and use '/' as separator.
+//       The metadata of an entry is only fetched on demand, and only the
+//       requested fields; symbolic links are followed.
+//       Every call to setDirectory() assigns a process-wide unique id, which
+//       allows filters to cache results depending on the directory only.
+
+class FindEntry {
+public:
+  FindEntry() = default;
+  ~FindEntry() = default;
+
+  FindEntry(const FindEntry&) = default;
+  FindEntry& operator=(const FindEntry&) = default;
+
+  FindEntry(FindEntry&&) = default;
+  FindEntry& operator=(FindEntry&&) = default;
+
+  // Path ////////////////////////////////////////////////////////////////////
+
+  QString completeSuffix() const;
+  uint64_t directoryId() const;
+  QString fileName() const;
+  QString filePath() const;
+  QString path() const;
+  QString suffix() const;
+
+  std::string_view fileNameView() const;
+  std::string_view filePathView() const;
+  std::string_view pathView() const;
+
+  // Type ////////////////////////////////////////////////////////////////////
+
+  bool isDir() const;
+  bool isFile() const;
+  bool isSymLink() const;
+  FindType type() const;
+
+  // Metadata ////////////////////////////////////////////////////////////////
+
+  bool hasMetadata() const;
+  int64_t lastModified() const;
+  const FindMetadata& metadata(const unsigned fields = FindMetadata::All) const;
+  uint64_t size() const;
+
+  // Walker //////////////////////////////////////////////////////////////////
+
+  void setDirectory(const std::string_view& dirPath, const int dirFd = -1);
+  void setMetadata(const FindMetadata& metadata, const unsigned fields, const FindType targetType);
+  void setName(const std::string_view& name, const FindType type);
+
+private:
+  void fetch(const unsigned fields) const;
+
+  std::string _path{};
+  std::string::size_type _nameOffset{0};
+  uint64_t _directoryId{0};
+  int _dirFd{-1};
+  FindType _type{FindType::Unknown};
+  mutable FindType _targetType{FindType::Unknown};
+  mutable unsigned _fetched{0};
+  mutable bool _haveMetadata{false};
+  mutable FindMetadata _metadata{};
+};
+
+#endif // FINDENTRY_H
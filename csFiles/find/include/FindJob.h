@@ -0,0 +1,109 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef FINDJOB_H
+#define FINDJOB_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <QtCore/QStringList>
+
+#include <csUtil/csFlags.h>
+
+#include "FilterPipeline.h"
+
+class LiveIndex;
+
+enum class FindFlag : unsigned {
+  NoFlags        = 0,
+  Directories    = 1,
+  Files          = 2,
+  FollowSymlinks = 4,
+  Subdirectories = 8,
+  IgnoreFiles    = 16, // Honour .gitignore, .ignore & excludes
+  SameFileSystem = 32  // Do not descend into other file systems
+};
+
+CS_ENABLE_FLAGS(FindFlag);
+
+using FindFlags = csFlags<FindFlag>;
+
+////// FindJob ///////////////////////////////////////////////////////////////
+
+struct FindJob {
+  FindJob() noexcept = default;
+  FindJob(const QString& _rootPath, const FindFlags _flags) noexcept;
+
+  FindJob(const FindJob&) = delete;
+  FindJob& operator=(const FindJob&) = delete;
+
+  FindJob(FindJob&&) noexcept = default;
+  FindJob& operator=(FindJob&&) noexcept = default;
+
+  QString rootPath{};
+  FindFlags flags{FindFlag::NoFlags};
+  IFindFilters filters{};
+  int numThreads{0}; // 0: QThread::idealThreadCount()
+  const std::atomic<bool> *cancel{nullptr}; // Stops traversal when set
+  QString snapshotFile{}; // Walks an up-to-date TreeSnapshot stored in this file, if set
+  const LiveIndex *index{nullptr}; // Walks the index instead, if it covers the root
+};
+
+////// FindStatistics ////////////////////////////////////////////////////////
+
+struct FindStatistics {
+  uint64_t directories{0};
+  uint64_t entries{0};
+  uint64_t repeats{0}; // Directories skipped as already visited or on another file system
+  FilterStatisticsList filters{}; // In order of FindJob::filters
+
+  FindStatistics& operator+=(const FindStatistics& other);
+};
+
+////// Functions /////////////////////////////////////////////////////////////
+
+// NOTE: Results are handed over in batches; the sink is never entered
+//       concurrently, but it is called from the traversal's threads!
+using FindResultsSink = std::function<void(const QStringList& batch)>;
+
+// NOTE: Neither 'Directories' nor 'Files' set lists both!
+//       The order of the results is unspecified.
+//       The file system is walked instead of an index, when following links
+//       or staying on one file system; and instead of a snapshot, also when
+//       filtering by metadata.
+QStringList executeFind(const FindJob& job, FindStatistics *stats = nullptr);
+void executeFind(const FindJob& job, const FindResultsSink& sink, FindStatistics *stats = nullptr);
+
+#endif // FINDJOB_H
@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef GLOBSET_H
+#define GLOBSET_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "KeyMap.h"
+
+// NOTE: A GlobSet compiles many globs for matching at once; supported are
+//       '*' and '?' (not matching '/'), '**' (matching across '/'),
+//       '[...]' character classes (negated by '!' or '^') and '\' escapes.
+//       Globs without wildcards, and of the forms '*.suffix' and 'prefix*',
+//       are matched by hash lookups; only the remaining globs are matched
+//       one after another.
+//       Case insensitive sets fold ASCII letters only.
+
+class GlobSet {
+public:
+  GlobSet(const bool caseInsensitive = false);
+  ~GlobSet() = default;
+
+  GlobSet(const GlobSet&) = default;
+  GlobSet& operator=(const GlobSet&) = default;
+
+  GlobSet(GlobSet&&) = default;
+  GlobSet& operator=(GlobSet&&) = default;
+
+  bool add(const std::string_view& glob);
+  int addList(const std::string_view& globs, const char sep = ',');
+  void clear();
+  int count() const;
+  bool isCaseInsensitive() const;
+  bool isEmpty() const;
+  int lastMatch(const std::string_view& s) const;
+  bool matches(const std::string_view& s) const;
+
+  static bool isMatch(const std::string_view& glob, const std::string_view& s);
+
+private:
+  int lastMatchFolded(const std::string_view& s) const;
+
+  struct Glob {
+    Glob(const std::string_view& _pattern, const int _index);
+
+    std::string pattern;
+    int index;
+  };
+
+  bool _caseInsensitive{false};
+  int _count{0};
+  KeyMap _literals{};
+  KeyMap _prefixes{};
+  KeyMap _suffixes{};
+  std::vector<Glob> _globs{};
+};
+
+#endif // GLOBSET_H
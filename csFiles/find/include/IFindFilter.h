@@ -34,7 +34,7 @@
 
 #include <memory>
 
-class QFileInfo;
+class FindEntry;
 
 using IFindFilterPtr = std::unique_ptr<class IFindFilter>;
 
@@ -42,14 +42,21 @@ class IFindFilter {
 public:
   virtual ~IFindFilter();
 
-  bool filtered(const QFileInfo& info) const;
+  virtual IFindFilterPtr clone() const = 0;
+  virtual const char *name() const = 0;
+  virtual bool needsMetadata() const;
+
+  bool active() const;
+  bool filtered(const FindEntry& entry) const;
+  bool isReject() const;
+  bool pruned(const FindEntry& dir) const;
 
 protected:
   IFindFilter(const bool reject);
 
   virtual bool isActive() const = 0;
-  virtual bool isMatch(const QFileInfo& info) const = 0;
-  bool isReject() const;
+  virtual bool isMatch(const FindEntry& entry) const = 0;
+  virtual bool isPrunable(const FindEntry& dir) const;
 
 private:
   IFindFilter() = delete;
@@ -0,0 +1,110 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef IGNORERULES_H
+#define IGNORERULES_H
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GlobSet.h"
+
+class FindEntry;
+
+////// IgnoreRules ///////////////////////////////////////////////////////////
+
+// NOTE: The rules of one ignore file in gitignore(5) syntax; the last
+//       matching rule wins. Rules containing a '/' are matched against the
+//       path relative to the file's directory, all others against the name.
+
+class IgnoreRules {
+public:
+  enum class Match {
+    None = 0,
+    Ignore,
+    Whitelist
+  };
+
+  IgnoreRules() = default;
+  ~IgnoreRules() = default;
+
+  void addRule(std::string_view line);
+  bool isEmpty() const;
+  bool load(const std::string& filename);
+  Match match(const std::string_view& relPath, const bool isDir) const;
+  void parse(const std::string_view& text);
+
+private:
+  enum SetIndex : int {
+    Names = 0,
+    Paths,
+    DirNames,
+    DirPaths,
+    NumSets
+  };
+
+  int lastMatch(const SetIndex set, const std::string_view& s) const;
+
+  GlobSet _sets[NumSets];
+  std::vector<int> _order[NumSets];
+  std::vector<bool> _negate; // by order
+};
+
+////// IgnoreLevel ///////////////////////////////////////////////////////////
+
+using IgnoreLevelPtr = std::shared_ptr<const class IgnoreLevel>;
+
+// NOTE: The ignore files of one directory; levels are inherited down the tree
+//       and consulted from the innermost to the outermost directory.
+//       Within a directory '.ignore' takes precedence over '.gitignore'.
+
+class IgnoreLevel {
+public:
+  ~IgnoreLevel();
+
+  bool isIgnored(const FindEntry& entry) const;
+
+  static IgnoreLevelPtr create(const IgnoreLevelPtr& parent, const std::string& dirPath);
+  static IgnoreLevelPtr createRoot(const std::string& rootPath);
+
+private:
+  IgnoreLevel(const IgnoreLevelPtr& parent, const std::string& dirPath);
+
+  IgnoreRules::Match match(const std::string_view& filePath, const bool isDir) const;
+
+  std::string _base{};
+  IgnoreLevelPtr _parent{};
+  std::vector<IgnoreRules> _rules{}; // by precedence
+};
+
+#endif // IGNORERULES_H
@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef KEYMAP_H
+#define KEYMAP_H
+
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// NOTE: Maps string keys to the largest index inserted for them; all keys
+//       are stored in one arena, such that lookups by std::string_view
+//       do not allocate. The sizes of the stored keys are tracked to support
+//       prefix and suffix lookups.
+
+inline char foldAscii(const char c)
+{
+  return 'A' <= c  &&  c <= 'Z'
+      ? char(c - 'A' + 'a')
+      : c;
+}
+
+class KeyMap {
+public:
+  using size_type = std::string::size_type;
+
+  KeyMap() = default;
+  ~KeyMap() = default;
+
+  KeyMap(const KeyMap&) = default;
+  KeyMap& operator=(const KeyMap&) = default;
+
+  KeyMap(KeyMap&&) = default;
+  KeyMap& operator=(KeyMap&&) = default;
+
+  void clear();
+  bool isEmpty() const;
+  void insert(const std::string_view& key, const int index);
+  const std::vector<size_type>& keySizes() const;
+  int lookup(const std::string_view& key) const;
+  int lookupPrefix(const std::string_view& s) const;
+  int lookupSuffix(const std::string_view& s) const;
+
+private:
+  struct Entry {
+    size_type offset;
+    size_type size;
+    int index;
+  };
+
+  using Entries = std::unordered_multimap<std::size_t,Entry>;
+
+  std::string _arena{};
+  Entries _entries{};
+  std::vector<size_type> _keySizes{};
+};
+
+#endif // KEYMAP_H
@@ -0,0 +1,124 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef LIVEINDEX_H
+#define LIVEINDEX_H
+
+#include <cstdint>
+
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "FindEntry.h"
+
+// NOTE: Keeps the entries of a watched tree in memory, updated from the
+//       file system's change notifications (inotify); hence repeated finds
+//       below the root never read a directory again.
+//       Like the snapshot, the index neither follows symbolic links nor
+//       lists hidden entries (cf. DirectoryReader); it records no devices.
+//       NOTE: Watching is only supported on Linux; if the notifications
+//             become incomplete (e.g. exhausted watches), the index stops
+//             covering any path until it is watched again.
+
+class LiveIndex {
+public:
+  using Listing = std::vector<std::pair<std::string,FindType>>;
+
+  LiveIndex() = default;
+  ~LiveIndex();
+
+  // NOTE: True if 'dirPath' is below the root and the index is complete.
+  bool covers(const std::string& dirPath) const;
+  bool list(const std::string& dirPath, Listing& entries) const;
+  std::string rootPath() const;
+
+  // NOTE: The tree is read in the background; it is covered once read.
+  bool watch(const std::string& rootPath);
+  void stop();
+
+  // NOTE: The index shared by all views of the application.
+  static LiveIndex *global();
+
+private:
+  LiveIndex(const LiveIndex&) = delete;
+  LiveIndex& operator=(const LiveIndex&) = delete;
+
+  LiveIndex(LiveIndex&&) = delete;
+  LiveIndex& operator=(LiveIndex&&) = delete;
+
+  struct Directory {
+    int wd{-1};
+    std::unordered_map<std::string,FindType> entries{};
+  };
+
+  bool addTree(const std::string& dirPath);
+  void handleEvents(const char *data, const long size);
+  void removeTree(const std::string& dirPath);
+  void rescan();
+  void run();
+
+  mutable std::shared_mutex _mutex;
+  std::string _rootPath{};
+  std::unordered_map<std::string,Directory> _dirs{};
+  std::unordered_map<int,std::string> _watches{};
+  bool _complete{false};
+  int _fd{-1};
+  int _stopFd{-1};
+  std::thread _thread{};
+};
+
+// NOTE: Lists the entries of an indexed directory into a FindEntry;
+//       cf. DirectoryReader.
+
+class IndexReader {
+public:
+  IndexReader() = default;
+  ~IndexReader() = default;
+
+  void close();
+  bool isOpen() const;
+  bool next(FindEntry& entry);
+  bool open(const LiveIndex *index, const std::string& dirPath, FindEntry& entry);
+
+private:
+  IndexReader(const IndexReader&) = delete;
+  IndexReader& operator=(const IndexReader&) = delete;
+
+  LiveIndex::Listing _entries{};
+  std::size_t _pos{0};
+  bool _open{false};
+};
+
+#endif // LIVEINDEX_H
@@ -0,0 +1,74 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef METADATAFILTER_H
+#define METADATAFILTER_H
+
+#include <cstdint>
+
+#include "FindEntry.h"
+#include "IFindFilter.h"
+
+struct MetadataCriteria {
+  int64_t  minSize{-1};        // [Byte]; < 0: unbounded
+  int64_t  maxSize{-1};        // [Byte]; < 0: unbounded
+  int64_t  modifiedAfter{0};   // [ms] since epoch; 0: unbounded
+  int64_t  modifiedBefore{0};  // [ms] since epoch; 0: unbounded
+  uint32_t permissions{0};     // All of these mode bits must be set
+  FindType type{FindType::Unknown}; // Unknown: Any type
+
+  bool isActive() const;
+  unsigned requiredFields() const;
+};
+
+class MetadataFilter : public IFindFilter {
+public:
+  ~MetadataFilter();
+
+  IFindFilterPtr clone() const;
+  const char *name() const;
+  bool needsMetadata() const;
+
+  static IFindFilterPtr create(const MetadataCriteria& criteria);
+
+protected:
+  bool isActive() const;
+  bool isMatch(const FindEntry& entry) const;
+
+private:
+  MetadataFilter() = delete;
+  MetadataFilter(const MetadataCriteria& criteria);
+
+  MetadataCriteria _criteria{};
+  unsigned _fields{0};
+};
+
+#endif // METADATAFILTER_H
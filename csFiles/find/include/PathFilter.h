@@ -32,25 +32,35 @@
 #ifndef PATHFILTER_H
 #define PATHFILTER_H
 
-#include <QtCore/QStringList>
+#include <cstdint>
 
+#include <QtCore/QString>
+
+#include "AhoCorasick.h"
 #include "IFindFilter.h"
 
 class PathFilter : public IFindFilter {
 public:
   ~PathFilter();
 
+  IFindFilterPtr clone() const;
+  const char *name() const;
+
   static IFindFilterPtr create(const QString& paths, const bool reject);
 
 protected:
   bool isActive() const;
-  bool isMatch(const QFileInfo& info) const;
+  bool isMatch(const FindEntry& entry) const;
+  bool isPrunable(const FindEntry& dir) const;
 
 private:
   PathFilter() = delete;
   PathFilter(const QString& paths, const bool reject);
 
-  QStringList _paths;
+  AhoCorasick _paths{};
+  // NOTE: Filters are owned by a single worker; hence caching is safe.
+  mutable uint64_t _cachedDirectoryId{0};
+  mutable bool _cachedMatch{false};
 };
 
 #endif // PATHFILTER_H
@@ -0,0 +1,109 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef PATHSTORE_H
+#define PATHSTORE_H
+
+#include <cstdint>
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QMetaType>
+#include <QtCore/QStringList>
+
+using FileId = uint32_t;
+
+using FileIds = std::vector<FileId>;
+
+Q_DECLARE_METATYPE(FileIds)
+
+using PathStorePtr = std::shared_ptr<class PathStore>;
+
+// NOTE: Stores paths as a table of components, each referring to the index
+//       of its parent; hence every directory's name is stored only once.
+//       The index of a path's last component is its (stable) FileId.
+//       Paths are ordered component by component, i.e. a directory's
+//       contents are always listed before any of its siblings following it.
+//       The store is safe to read while being inserted to. It never shrinks;
+//       hence every view owns its store and releases it with its model.
+
+class PathStore {
+public:
+  PathStore() = default;
+  ~PathStore() = default;
+
+  PathStore(const PathStore&) = delete;
+  PathStore& operator=(const PathStore&) = delete;
+
+  PathStore(PathStore&&) = delete;
+  PathStore& operator=(PathStore&&) = delete;
+
+  QString fileName(const FileId id) const;
+  QString filePath(const FileId id) const;
+  QStringList filePaths(const FileIds& ids) const;
+  FileId insert(const QString& filePath);
+  FileIds insert(const QStringList& filePaths);
+  bool isLess(const FileId a, const FileId b) const;
+  bool isValid(const FileId id) const;
+  QString relativeFilePath(const FileId id, const FileId ancestor) const;
+  std::size_t size() const;
+  void sort(FileIds& ids) const;
+
+  static PathStorePtr create();
+
+private:
+  struct Node {
+    FileId   parent;
+    uint32_t offset;
+    uint16_t size;
+    uint16_t depth;
+  };
+
+  using Index = std::unordered_multimap<std::size_t,FileId>;
+
+  std::string filePathUtf8(const FileId id, const FileId ancestor) const;
+  FileId insertComponent(const FileId parent, const std::string_view& name);
+  FileId insertPath(const QString& filePath);
+  bool isLessUnlocked(FileId a, FileId b) const;
+  std::string_view name(const Node& node) const;
+
+  mutable std::shared_mutex _mutex;
+  std::string _names{};
+  std::vector<Node> _nodes{};
+  Index _index{};
+};
+
+#endif // PATHSTORE_H
@@ -0,0 +1,159 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef TREESNAPSHOT_H
+#define TREESNAPSHOT_H
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <QtCore/QFile>
+
+#include "FindEntry.h"
+
+// NOTE: A snapshot stores a directory tree below its root, i.e. the names,
+//       types, modes, sizes and modification times of all entries, as
+//       flat tables in one file; the file is mapped into memory when loaded.
+//       The entries of a directory are stored contiguously; a directory
+//       entry refers to the record of its subdirectory.
+//       A snapshot is revalidated by comparing the modification times of
+//       its directories; only changed directories are read again.
+//       Symbolic links are recorded, but never followed; hidden entries
+//       are skipped (cf. DirectoryReader).
+//       NOTE: Modifying a file does not modify its directory; hence the
+//             sizes and times of files are as current as their directory.
+
+class TreeSnapshot;
+
+using TreeSnapshotPtr = std::unique_ptr<TreeSnapshot>;
+
+class TreeSnapshot {
+public:
+  struct Directory {
+    uint32_t name;
+    uint32_t nameSize;
+    uint32_t parent;
+    uint32_t firstEntry;
+    uint32_t numEntries;
+    uint32_t reserved;
+    int64_t  lastModified; // [ms] since epoch
+  };
+
+  struct Entry {
+    uint32_t name;
+    uint16_t nameSize;
+    uint8_t  type;       // FindType of the entry itself
+    uint8_t  targetType; // FindType of the link's target, if any; Unknown w/o metadata
+    uint32_t mode;       // Of the link's target, if any
+    uint32_t child;      // Directory record of a subdirectory; kNoDirectory otherwise
+    uint64_t size;
+    int64_t  lastModified; // [ms] since epoch
+  };
+
+  static constexpr uint32_t kNoDirectory = 0xFFFFFFFF;
+  static constexpr uint32_t kRootDirectory = 0;
+
+  ~TreeSnapshot();
+
+  std::size_t directoryCount() const;
+  const Directory& directory(const uint32_t index) const;
+  std::size_t entryCount() const;
+  const Entry& entry(const uint32_t index) const;
+  std::string_view name(const Directory& dir) const;
+  std::string_view name(const Entry& entry) const;
+  std::string_view rootPath() const;
+
+  // NOTE: Loads the snapshot of 'rootPath' from 'filename' and brings it
+  //       up to date; the file is (re-)written if anything changed.
+  //       Returns an empty pointer if the root is not a readable directory.
+  static TreeSnapshotPtr update(const QString& filename, const std::string& rootPath,
+                                bool *changed = nullptr);
+
+private:
+  TreeSnapshot() = default;
+
+  TreeSnapshot(const TreeSnapshot&) = delete;
+  TreeSnapshot& operator=(const TreeSnapshot&) = delete;
+
+  TreeSnapshot(TreeSnapshot&&) = delete;
+  TreeSnapshot& operator=(TreeSnapshot&&) = delete;
+
+  bool load(const QString& filename);
+  bool save(const QString& filename) const;
+
+  // Mapped file, if loaded
+  QFile _file;
+  // Tables, if built
+  std::vector<Directory> _dirStorage;
+  std::vector<Entry> _entryStorage;
+  std::string _nameStorage;
+  // Views of the tables
+  const Directory *_dirs{nullptr};
+  std::size_t _numDirs{0};
+  const Entry *_entries{nullptr};
+  std::size_t _numEntries{0};
+  std::string_view _names{};
+  std::size_t _rootSize{0};
+  int64_t _created{0};
+
+  friend class SnapshotBuilder;
+};
+
+// NOTE: Lists the entries of a snapshot's directory into a FindEntry,
+//       including their metadata; cf. DirectoryReader.
+
+class SnapshotReader {
+public:
+  SnapshotReader() = default;
+  ~SnapshotReader() = default;
+
+  uint32_t child() const;
+  void close();
+  bool isOpen() const;
+  bool next(FindEntry& entry);
+  bool open(const TreeSnapshot *snapshot, const uint32_t dir,
+            const std::string& dirPath, FindEntry& entry);
+
+private:
+  SnapshotReader(const SnapshotReader&) = delete;
+  SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+  const TreeSnapshot *_snapshot{nullptr};
+  uint32_t _pos{0};
+  uint32_t _end{0};
+  uint32_t _child{TreeSnapshot::kNoDirectory};
+};
+
+#endif // TREESNAPSHOT_H
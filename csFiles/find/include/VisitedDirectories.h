@@ -0,0 +1,82 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef VISITEDDIRECTORIES_H
+#define VISITEDDIRECTORIES_H
+
+#include <cstdint>
+
+#include <array>
+#include <mutex>
+#include <unordered_set>
+
+// NOTE: Identifies a directory independent of the path it was reached by.
+
+struct DirectoryIdentity {
+  uint64_t device{0};
+  uint64_t inode{0};
+};
+
+bool operator==(const DirectoryIdentity& a, const DirectoryIdentity& b);
+
+// NOTE: A set of directories shared by all workers of a traversal;
+//       the set is split into shards, each guarded by its own mutex.
+
+class VisitedDirectories {
+public:
+  VisitedDirectories() = default;
+  ~VisitedDirectories() = default;
+
+  // NOTE: Returns true if the directory was not visited before.
+  bool insert(const DirectoryIdentity& id);
+
+private:
+  VisitedDirectories(const VisitedDirectories&) = delete;
+  VisitedDirectories& operator=(const VisitedDirectories&) = delete;
+
+  VisitedDirectories(VisitedDirectories&&) = delete;
+  VisitedDirectories& operator=(VisitedDirectories&&) = delete;
+
+  struct Hash {
+    std::size_t operator()(const DirectoryIdentity& id) const;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_set<DirectoryIdentity,Hash> set;
+  };
+
+  static constexpr std::size_t kNumShards = 64;
+
+  std::array<Shard,kNumShards> _shards;
+};
+
+#endif // VISITEDDIRECTORIES_H
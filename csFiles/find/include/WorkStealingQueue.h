@@ -0,0 +1,157 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef WORKSTEALINGQUEUE_H
+#define WORKSTEALINGQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// NOTE: Every worker owns a deque; the owner pushes and pops at the back
+//       (depth first), idle workers steal from the front of other deques.
+//       An item is pending until its worker calls done(); the queue is
+//       exhausted when no item is pending.
+
+template<typename T>
+class WorkStealingQueue {
+public:
+  using value_type = T;
+
+  // Construction ////////////////////////////////////////////////////////////
+
+  WorkStealingQueue(const int numWorkers)
+  {
+    _deques.resize(static_cast<std::size_t>(numWorkers < 1 ? 1 : numWorkers));
+    for(std::unique_ptr<Deque>& d : _deques) {
+      d.reset(new Deque);
+    }
+  }
+
+  ~WorkStealingQueue() = default;
+
+  // Workers /////////////////////////////////////////////////////////////////
+
+  void done()
+  {
+    if( _pending.fetch_sub(1, std::memory_order_acq_rel) == 1 ) {
+      std::lock_guard<std::mutex> lock(_idleMutex);
+      _idle.notify_all();
+    }
+  }
+
+  bool pop(const int worker, value_type& item)
+  {
+    while( true ) {
+      if( popBack(worker, item)  ||  steal(worker, item) ) {
+        return true;
+      }
+
+      if( _pending.load(std::memory_order_acquire) == 0 ) {
+        return false;
+      }
+
+      std::unique_lock<std::mutex> lock(_idleMutex);
+      _idle.wait_for(lock, std::chrono::milliseconds(1));
+    }
+  }
+
+  void push(const int worker, value_type&& item)
+  {
+    _pending.fetch_add(1, std::memory_order_acq_rel);
+    {
+      Deque& d = deque(worker);
+      std::lock_guard<std::mutex> lock(d.mutex);
+      d.items.push_back(std::move(item));
+    }
+    _idle.notify_one();
+  }
+
+  inline int workerCount() const
+  {
+    return static_cast<int>(_deques.size());
+  }
+
+private:
+  WorkStealingQueue(const WorkStealingQueue&) = delete;
+  WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+  WorkStealingQueue(WorkStealingQueue&&) = delete;
+  WorkStealingQueue& operator=(WorkStealingQueue&&) = delete;
+
+  struct Deque {
+    std::mutex mutex;
+    std::deque<value_type> items;
+  };
+
+  inline Deque& deque(const int worker)
+  {
+    return *_deques[static_cast<std::size_t>(worker)%_deques.size()];
+  }
+
+  bool popBack(const int worker, value_type& item)
+  {
+    Deque& d = deque(worker);
+    std::lock_guard<std::mutex> lock(d.mutex);
+    if( d.items.empty() ) {
+      return false;
+    }
+    item = std::move(d.items.back());
+    d.items.pop_back();
+    return true;
+  }
+
+  bool steal(const int worker, value_type& item)
+  {
+    for(int i = 1; i < workerCount(); i++) {
+      Deque& d = deque(worker + i);
+      std::lock_guard<std::mutex> lock(d.mutex);
+      if( d.items.empty() ) {
+        continue;
+      }
+      item = std::move(d.items.front());
+      d.items.pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  std::vector<std::unique_ptr<Deque>> _deques;
+  std::atomic<std::size_t> _pending{0};
+  std::condition_variable _idle;
+  std::mutex _idleMutex;
+};
+
+#endif // WORKSTEALINGQUEUE_H
@@ -0,0 +1,142 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <deque>
+
+#include "AhoCorasick.h"
+
+#include "KeyMap.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+AhoCorasick::AhoCorasick(const std::vector<std::string>& patterns, const bool caseInsensitive)
+{
+  // (1) Trie; missing transitions are -1 ////////////////////////////////////
+
+  _next.assign(kAlphabet, -1);
+  _final.assign(1, false);
+
+  for(const std::string& pattern : patterns) {
+    if( pattern.empty() ) {
+      continue;
+    }
+
+    State s = 0;
+    for(const char ch : pattern) {
+      const unsigned char c = static_cast<unsigned char>(caseInsensitive ? foldAscii(ch) : ch);
+      const std::size_t   i = std::size_t(s)*kAlphabet + c;
+      if( _next[i] < 0 ) {
+        _next[i] = static_cast<State>(_final.size());
+        _next.insert(_next.end(), kAlphabet, -1);
+        _final.push_back(false);
+      }
+      s = _next[i];
+    }
+    _final[std::size_t(s)] = true;
+  }
+
+  if( _final.size() < 2 ) {
+    _next.clear();
+    _final.clear();
+    return;
+  }
+
+  // (2) Complete DFA by breadth first traversal of failure links ////////////
+
+  std::vector<State> fail(_final.size(), 0);
+  std::deque<State> queue;
+
+  for(int c = 0; c < kAlphabet; c++) {
+    State& t = _next[std::size_t(c)];
+    if( t < 0 ) {
+      t = 0;
+    } else {
+      queue.push_back(t);
+    }
+  }
+
+  while( !queue.empty() ) {
+    const State s = queue.front();
+    queue.pop_front();
+
+    // NOTE: Reaching any pattern's end via the failure link is a match, too!
+    if( _final[std::size_t(fail[std::size_t(s)])] ) {
+      _final[std::size_t(s)] = true;
+    }
+
+    for(int c = 0; c < kAlphabet; c++) {
+      State& t = _next[std::size_t(s)*kAlphabet + std::size_t(c)];
+      if( t < 0 ) {
+        t = next(fail[std::size_t(s)], static_cast<unsigned char>(c));
+      } else {
+        fail[std::size_t(t)] = next(fail[std::size_t(s)], static_cast<unsigned char>(c));
+        queue.push_back(t);
+      }
+    }
+  }
+
+  // (3) Map upper case onto lower case transitions //////////////////////////
+
+  if( caseInsensitive ) {
+    for(std::size_t s = 0; s < _final.size(); s++) {
+      for(int c = 'A'; c <= 'Z'; c++) {
+        _next[s*kAlphabet + std::size_t(c)] = _next[s*kAlphabet + std::size_t(c - 'A' + 'a')];
+      }
+    }
+  }
+}
+
+bool AhoCorasick::containsAny(const std::string_view& text) const
+{
+  if( isEmpty() ) {
+    return false;
+  }
+
+  State s = 0;
+  for(const char c : text) {
+    s = next(s, static_cast<unsigned char>(c));
+    if( _final[std::size_t(s)] ) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool AhoCorasick::isEmpty() const
+{
+  return _final.empty();
+}
+
+int AhoCorasick::stateCount() const
+{
+  return static_cast<int>(_final.size());
+}
@@ -0,0 +1,245 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QtGlobal>
+
+#ifdef Q_OS_LINUX
+# include <dirent.h>
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#else
+# include <functional>
+
+# include <QtCore/QDirIterator>
+#endif
+
+#include "DirectoryReader.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr std::size_t kBufferSize = 64*1024;
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+#ifdef Q_OS_LINUX
+  struct linux_dirent64 {
+    ino64_t        d_ino;
+    off64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[];
+  };
+
+  FindType toFindType(const unsigned char d_type)
+  {
+    switch( d_type ) {
+    case DT_DIR:
+      return FindType::Directory;
+    case DT_REG:
+      return FindType::File;
+    case DT_LNK:
+      return FindType::SymLink;
+    case DT_UNKNOWN:
+      return FindType::Unknown;
+    default:
+      break;
+    }
+    return FindType::Other;
+  }
+#endif
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+DirectoryReader::DirectoryReader()
+{
+}
+
+DirectoryReader::~DirectoryReader()
+{
+  close();
+}
+
+#ifdef Q_OS_LINUX
+
+void DirectoryReader::close()
+{
+  if( _fd >= 0 ) {
+    ::close(_fd);
+  }
+  _fd = -1;
+  _pos = _end = 0;
+}
+
+bool DirectoryReader::identity(DirectoryIdentity& id) const
+{
+  struct stat st;
+  if( !isOpen()  ||  ::fstat(_fd, &st) != 0 ) {
+    return false;
+  }
+  id.device = static_cast<uint64_t>(st.st_dev);
+  id.inode  = static_cast<uint64_t>(st.st_ino);
+  return true;
+}
+
+bool DirectoryReader::isOpen() const
+{
+  return _fd >= 0;
+}
+
+bool DirectoryReader::next(FindEntry& entry)
+{
+  while( isOpen() ) {
+    if( _pos >= _end  &&  !fill() ) {
+      close();
+      break;
+    }
+
+    const priv::linux_dirent64 *d =
+        reinterpret_cast<const priv::linux_dirent64*>(_buffer.data() + _pos);
+    _pos += d->d_reclen;
+
+    // NOTE: Skip '.', '..' and hidden entries (cf. QDir::Hidden)!
+    if( d->d_name[0] == '.' ) {
+      continue;
+    }
+
+    entry.setName(std::string_view(d->d_name), priv::toFindType(d->d_type));
+    return true;
+  }
+
+  return false;
+}
+
+bool DirectoryReader::open(const std::string& dirPath, FindEntry& entry)
+{
+  close();
+
+  _fd = ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if( _fd < 0 ) {
+    return false;
+  }
+
+  if( _buffer.size() < kBufferSize ) {
+    _buffer.resize(kBufferSize);
+  }
+
+  entry.setDirectory(dirPath, _fd);
+
+  return true;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool DirectoryReader::fill()
+{
+  const long numRead = ::syscall(SYS_getdents64, _fd, _buffer.data(), _buffer.size());
+  if( numRead <= 0 ) {
+    return false;
+  }
+  _pos = 0;
+  _end = numRead;
+  return true;
+}
+
+#else
+
+void DirectoryReader::close()
+{
+  _iter.reset();
+  _path.clear();
+}
+
+// NOTE: Without (device, inode), a directory is identified by its canonical path.
+bool DirectoryReader::identity(DirectoryIdentity& id) const
+{
+  if( !isOpen() ) {
+    return false;
+  }
+  const std::string canonical = QFileInfo(QString::fromStdString(_path)).canonicalFilePath().toStdString();
+  if( canonical.empty() ) {
+    return false;
+  }
+  id.device = 0;
+  id.inode  = static_cast<uint64_t>(std::hash<std::string>()(canonical));
+  return true;
+}
+
+bool DirectoryReader::isOpen() const
+{
+  return static_cast<bool>(_iter);
+}
+
+bool DirectoryReader::next(FindEntry& entry)
+{
+  if( !isOpen()  ||  !_iter->hasNext() ) {
+    close();
+    return false;
+  }
+
+  _iter->next();
+  const QFileInfo info = _iter->fileInfo();
+  const QByteArray name = info.fileName().toUtf8();
+
+  const FindType type = info.isSymLink()
+      ? FindType::SymLink
+      : info.isDir()
+        ? FindType::Directory
+        : info.isFile()
+          ? FindType::File
+          : FindType::Other;
+  entry.setName(std::string_view(name.constData(), std::size_t(name.size())), type);
+
+  return true;
+}
+
+bool DirectoryReader::open(const std::string& dirPath, FindEntry& entry)
+{
+  close();
+
+  const QString path = QString::fromStdString(dirPath);
+  if( !QFileInfo(path).isDir() ) {
+    return false;
+  }
+
+  _iter.reset(new QDirIterator(path, QDir::AllEntries | QDir::System | QDir::NoDotAndDotDot));
+  _path = dirPath;
+  entry.setDirectory(dirPath);
+
+  return true;
+}
+
+#endif
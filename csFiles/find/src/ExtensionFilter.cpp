@@ -29,18 +29,33 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <QtCore/QFileInfo>
+#include <algorithm>
 
 #include "ExtensionFilter.h"
 
+#include "FindEntry.h"
 #include "PatternList.h"
 
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr std::size_t kMaxExtension = 64;
+
 ////// public ////////////////////////////////////////////////////////////////
 
 ExtensionFilter::~ExtensionFilter()
 {
 }
 
+IFindFilterPtr ExtensionFilter::clone() const
+{
+  return IFindFilterPtr(new ExtensionFilter(*this));
+}
+
+const char *ExtensionFilter::name() const
+{
+  return "extension";
+}
+
 IFindFilterPtr ExtensionFilter::create(const QString& extensions, const bool reject,
                                        const bool complete)
 {
@@ -54,12 +69,25 @@ bool ExtensionFilter::isActive() const
   return !_extensions.isEmpty();
 }
 
-bool ExtensionFilter::isMatch(const QFileInfo& info) const
+bool ExtensionFilter::isMatch(const FindEntry& entry) const
 {
-  if( _complete ) {
-    return _extensions.contains(info.completeSuffix(), Qt::CaseInsensitive);
+  const std::string_view name = entry.fileNameView();
+  const std::string_view::size_type pos = _complete
+      ? name.find('.')
+      : name.rfind('.');
+  if( pos == std::string_view::npos ) {
+    return false;
+  }
+
+  const std::string_view suffix = name.substr(pos + 1);
+  if( suffix.empty()  ||  suffix.size() > kMaxExtension ) {
+    return false;
   }
-  return _extensions.contains(info.suffix(), Qt::CaseInsensitive);
+
+  char folded[kMaxExtension];
+  std::transform(suffix.cbegin(), suffix.cend(), folded, foldAscii);
+
+  return _extensions.lookup(std::string_view(folded, suffix.size())) >= 0;
 }
 
 ////// private ///////////////////////////////////////////////////////////////
@@ -69,5 +97,11 @@ ExtensionFilter::ExtensionFilter(const QString& extensions, const bool reject,
   : IFindFilter(reject)
   , _complete{complete}
 {
-  _extensions = preparePatternList(extensions);
+  int index = 0;
+  for(const QString& extension : preparePatternList(extensions)) {
+    const std::string key = extension.toLower().toStdString();
+    if( key.size() <= kMaxExtension ) {
+      _extensions.insert(key, index++);
+    }
+  }
 }
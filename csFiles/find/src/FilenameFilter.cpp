@@ -29,16 +29,26 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <QtCore/QFileInfo>
-
 #include "FilenameFilter.h"
 
+#include "FindEntry.h"
+
 ////// public ////////////////////////////////////////////////////////////////
 
 FilenameFilter::~FilenameFilter()
 {
 }
 
+IFindFilterPtr FilenameFilter::clone() const
+{
+  return IFindFilterPtr(new FilenameFilter(*this));
+}
+
+const char *FilenameFilter::name() const
+{
+  return "filename";
+}
+
 IFindFilterPtr FilenameFilter::create(const QString& pattern, const bool reject)
 {
   return IFindFilterPtr(new FilenameFilter(pattern, reject));
@@ -48,24 +58,19 @@ IFindFilterPtr FilenameFilter::create(const QString& pattern, const bool reject)
 
 bool FilenameFilter::isActive() const
 {
-  return !_pattern.isEmpty();
+  return !_globs.isEmpty();
 }
 
-bool FilenameFilter::isMatch(const QFileInfo& info) const
+bool FilenameFilter::isMatch(const FindEntry& entry) const
 {
-  return _regexp.exactMatch(info.fileName());
+  return _globs.matches(entry.fileNameView());
 }
 
 ////// private ///////////////////////////////////////////////////////////////
 
 FilenameFilter::FilenameFilter(const QString& pattern, const bool reject)
   : IFindFilter(reject)
-  , _pattern(pattern)
 {
-  if( _pattern.isEmpty() ) {
-    return;
-  }
-  _regexp.setCaseSensitivity(Qt::CaseInsensitive);
-  _regexp.setPatternSyntax(QRegExp::Wildcard);
-  _regexp.setPattern(_pattern);
+  // NOTE: Multiple patterns are separated by ','.
+  _globs.addList(pattern.toStdString());
 }
@@ -0,0 +1,183 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+
+#include "FilterPipeline.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr uint64_t kReorderInterval = 4096; // Calls between reorders
+constexpr uint64_t kSampleInterval  =   64; // Calls between timed calls
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  using Clock = std::chrono::steady_clock;
+
+  inline uint64_t elapsedNs(const Clock::time_point& start)
+  {
+    using namespace std::chrono;
+    return uint64_t(duration_cast<nanoseconds>(Clock::now() - start).count());
+  }
+
+} // namespace priv
+
+////// FilterStatistics - public /////////////////////////////////////////////
+
+double FilterStatistics::cost() const
+{
+  return samples > 0
+      ? double(sampledNs)/double(samples)
+      : 1.0;
+}
+
+// NOTE: Laplace smoothing keeps unseen filters from ranking first or last.
+double FilterStatistics::selectivity() const
+{
+  return (double(rejects) + 1.0)/(double(calls) + 2.0);
+}
+
+FilterStatistics& FilterStatistics::operator+=(const FilterStatistics& other)
+{
+  active     = active  ||  other.active;
+  calls     += other.calls;
+  rejects   += other.rejects;
+  prunes    += other.prunes;
+  samples   += other.samples;
+  sampledNs += other.sampledNs;
+  return *this;
+}
+
+////// FilterPipeline - public ///////////////////////////////////////////////
+
+FilterPipeline::FilterPipeline(const IFindFilters& filters)
+  : _numFilters{static_cast<int>(filters.size())}
+{
+  _stages.reserve(filters.size());
+  for(std::size_t i = 0; i < filters.size(); i++) {
+    if( !filters[i]  ||  !filters[i]->active() ) {
+      continue;
+    }
+
+    Stage stage{filters[i]->clone(), static_cast<int>(i), FilterStatistics()};
+    stage.stats.name   = filters[i]->name();
+    stage.stats.reject = filters[i]->isReject();
+    stage.stats.active = true;
+
+    _stages.push_back(std::move(stage));
+  }
+
+  reorder();
+}
+
+FilterPipeline::~FilterPipeline()
+{
+}
+
+bool FilterPipeline::filtered(const FindEntry& entry)
+{
+  if( _stages.empty() ) {
+    return false;
+  }
+
+  const bool timed = _numCalls%kSampleInterval == 0;
+  if( ++_numCalls%kReorderInterval == 0 ) {
+    reorder();
+  }
+
+  for(Stage& stage : _stages) {
+    stage.stats.calls++;
+
+    bool is_filtered = false;
+    if( timed ) {
+      const priv::Clock::time_point start = priv::Clock::now();
+      is_filtered = stage.filter->filtered(entry);
+      stage.stats.sampledNs += priv::elapsedNs(start);
+      stage.stats.samples++;
+    } else {
+      is_filtered = stage.filter->filtered(entry);
+    }
+
+    if( is_filtered ) {
+      stage.stats.rejects++;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool FilterPipeline::isEmpty() const
+{
+  return _stages.empty();
+}
+
+bool FilterPipeline::pruned(const FindEntry& dir)
+{
+  for(Stage& stage : _stages) {
+    if( stage.filter->pruned(dir) ) {
+      stage.stats.prunes++;
+      return true;
+    }
+  }
+  return false;
+}
+
+FilterStatisticsList FilterPipeline::statistics() const
+{
+  FilterStatisticsList result(static_cast<std::size_t>(_numFilters));
+  for(const Stage& stage : _stages) {
+    result[static_cast<std::size_t>(stage.index)] = stage.stats;
+  }
+  return result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+// NOTE: For a chain of independent rejecting predicates the expected cost is
+//       minimal, if ordered by ascending cost/P(reject); however, filters
+//       requiring metadata always go last, such that name-only filters
+//       spare the stat() for all entries they reject.
+void FilterPipeline::reorder()
+{
+  std::stable_sort(_stages.begin(), _stages.end(),
+                   [](const Stage& a, const Stage& b) -> bool {
+    const bool a_meta = a.filter->needsMetadata();
+    const bool b_meta = b.filter->needsMetadata();
+    if( a_meta != b_meta ) {
+      return b_meta;
+    }
+    return a.stats.cost()/a.stats.selectivity() < b.stats.cost()/b.stats.selectivity();
+  });
+}
@@ -0,0 +1,313 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QtGlobal>
+
+#ifdef Q_OS_LINUX
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <sys/sysmacros.h>
+#else
+# include <QtCore/QDateTime>
+# include <QtCore/QFileInfo>
+#endif
+
+#include <atomic>
+
+#include "FindEntry.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  std::atomic<uint64_t> nextDirectoryId{1};
+
+  inline QString toQString(const std::string_view& s)
+  {
+    return QString::fromUtf8(s.data(), static_cast<int>(s.size()));
+  }
+
+#ifdef Q_OS_LINUX
+  FindType toFindType(const unsigned int mode)
+  {
+    if(        S_ISDIR(mode) ) {
+      return FindType::Directory;
+    } else if( S_ISREG(mode) ) {
+      return FindType::File;
+    } else if( S_ISLNK(mode) ) {
+      return FindType::SymLink;
+    }
+    return FindType::Other;
+  }
+#else
+  uint32_t toMode(const QFile::Permissions p)
+  {
+    uint32_t result = 0;
+    result |= p.testFlag(QFile::ReadOwner)  ? 0400 : 0;
+    result |= p.testFlag(QFile::WriteOwner) ? 0200 : 0;
+    result |= p.testFlag(QFile::ExeOwner)   ? 0100 : 0;
+    result |= p.testFlag(QFile::ReadGroup)  ? 0040 : 0;
+    result |= p.testFlag(QFile::WriteGroup) ? 0020 : 0;
+    result |= p.testFlag(QFile::ExeGroup)   ? 0010 : 0;
+    result |= p.testFlag(QFile::ReadOther)  ? 0004 : 0;
+    result |= p.testFlag(QFile::WriteOther) ? 0002 : 0;
+    result |= p.testFlag(QFile::ExeOther)   ? 0001 : 0;
+    return result;
+  }
+#endif
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+QString FindEntry::completeSuffix() const
+{
+  const std::string_view name = fileNameView();
+  const std::string_view::size_type pos = name.find('.');
+  return pos != std::string_view::npos
+      ? priv::toQString(name.substr(pos + 1))
+      : QString();
+}
+
+uint64_t FindEntry::directoryId() const
+{
+  return _directoryId;
+}
+
+QString FindEntry::fileName() const
+{
+  return priv::toQString(fileNameView());
+}
+
+QString FindEntry::filePath() const
+{
+  return priv::toQString(filePathView());
+}
+
+QString FindEntry::path() const
+{
+  return priv::toQString(pathView());
+}
+
+QString FindEntry::suffix() const
+{
+  const std::string_view name = fileNameView();
+  const std::string_view::size_type pos = name.rfind('.');
+  return pos != std::string_view::npos
+      ? priv::toQString(name.substr(pos + 1))
+      : QString();
+}
+
+std::string_view FindEntry::fileNameView() const
+{
+  return filePathView().substr(_nameOffset);
+}
+
+std::string_view FindEntry::filePathView() const
+{
+  return std::string_view(_path);
+}
+
+std::string_view FindEntry::pathView() const
+{
+  // NOTE: Strip trailing separator, unless it is the root directory!
+  return _nameOffset > 1
+      ? filePathView().substr(0, _nameOffset - 1)
+      : filePathView().substr(0, _nameOffset);
+}
+
+bool FindEntry::isDir() const
+{
+  return type() == FindType::Directory;
+}
+
+bool FindEntry::isFile() const
+{
+  return type() == FindType::File;
+}
+
+bool FindEntry::isSymLink() const
+{
+  return _type == FindType::SymLink;
+}
+
+FindType FindEntry::type() const
+{
+  if( _type == FindType::SymLink  ||  _type == FindType::Unknown ) {
+    fetch(FindMetadata::Type);
+    return _targetType;
+  }
+  return _type;
+}
+
+bool FindEntry::hasMetadata() const
+{
+  fetch(FindMetadata::Type);
+  return _haveMetadata;
+}
+
+int64_t FindEntry::lastModified() const
+{
+  return metadata(FindMetadata::LastModified).lastModified;
+}
+
+const FindMetadata& FindEntry::metadata(const unsigned fields) const
+{
+  fetch(fields);
+  return _metadata;
+}
+
+uint64_t FindEntry::size() const
+{
+  return metadata(FindMetadata::Size).size;
+}
+
+void FindEntry::setDirectory(const std::string_view& dirPath, const int dirFd)
+{
+  _path.assign(dirPath.data(), dirPath.size());
+  if( _path.empty()  ||  _path.back() != '/' ) {
+    _path.push_back('/');
+  }
+  _nameOffset = _path.size();
+  _directoryId = priv::nextDirectoryId.fetch_add(1, std::memory_order_relaxed);
+  _dirFd = dirFd;
+  setName(std::string_view(), FindType::Unknown);
+}
+
+// NOTE: Provides metadata known in advance, e.g. from a snapshot.
+void FindEntry::setMetadata(const FindMetadata& metadata, const unsigned fields,
+                            const FindType targetType)
+{
+  _metadata = metadata;
+  _fetched = fields | FindMetadata::Type;
+  _haveMetadata = true;
+  _targetType = targetType;
+}
+
+void FindEntry::setName(const std::string_view& name, const FindType type)
+{
+  _path.resize(_nameOffset);
+  _path.append(name.data(), name.size());
+  _type = type;
+  _targetType = FindType::Unknown;
+  _fetched = 0;
+  _haveMetadata = false;
+  _metadata = FindMetadata();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void FindEntry::fetch(const unsigned fields) const
+{
+  const unsigned missing = fields & ~_fetched;
+  if( missing == 0 ) {
+    return;
+  }
+
+#ifdef Q_OS_LINUX
+  // NOTE: Relative to the directory's descriptor, if available.
+  const int   fd = _dirFd >= 0 ? _dirFd : AT_FDCWD;
+  const char *fn = _dirFd >= 0
+      ? _path.c_str() + _nameOffset
+      : _path.c_str();
+
+# ifdef STATX_BASIC_STATS
+  unsigned int mask = STATX_TYPE;
+  if( (missing & FindMetadata::Mode) != 0 ) {
+    mask |= STATX_MODE;
+  }
+  if( (missing & FindMetadata::Identity) != 0 ) {
+    mask |= STATX_INO;
+  }
+  if( (missing & FindMetadata::Size) != 0 ) {
+    mask |= STATX_SIZE;
+  }
+  if( (missing & FindMetadata::LastModified) != 0 ) {
+    mask |= STATX_MTIME;
+  }
+
+  struct statx buf;
+  if( ::statx(fd, fn, AT_NO_AUTOMOUNT, mask, &buf) != 0 ) {
+    _fetched = FindMetadata::All; // Do not retry!
+    _haveMetadata = false;
+    return;
+  }
+  _fetched |= missing | FindMetadata::Type;
+
+  _metadata.mode = (mask & STATX_MODE) != 0
+      ? uint32_t(buf.stx_mode)
+      : (_metadata.mode & ~uint32_t(S_IFMT)) | (uint32_t(buf.stx_mode) & uint32_t(S_IFMT));
+  if( (mask & STATX_INO) != 0 ) {
+    _metadata.device = uint64_t(makedev(buf.stx_dev_major, buf.stx_dev_minor));
+    _metadata.inode  = buf.stx_ino;
+  }
+  if( (mask & STATX_SIZE) != 0 ) {
+    _metadata.size = buf.stx_size;
+  }
+  if( (mask & STATX_MTIME) != 0 ) {
+    _metadata.lastModified = int64_t(buf.stx_mtime.tv_sec)*1000 + int64_t(buf.stx_mtime.tv_nsec)/1000000;
+  }
+# else
+  struct stat buf;
+  if( ::fstatat(fd, fn, &buf, 0) != 0 ) {
+    _fetched = FindMetadata::All; // Do not retry!
+    _haveMetadata = false;
+    return;
+  }
+  _fetched = FindMetadata::All;
+
+  _metadata.device       = uint64_t(buf.st_dev);
+  _metadata.inode        = uint64_t(buf.st_ino);
+  _metadata.mode         = uint32_t(buf.st_mode);
+  _metadata.size         = uint64_t(buf.st_size);
+  _metadata.lastModified = int64_t(buf.st_mtim.tv_sec)*1000 + int64_t(buf.st_mtim.tv_nsec)/1000000;
+# endif
+  _targetType = priv::toFindType(_metadata.mode);
+#else
+  _fetched = FindMetadata::All;
+
+  const QFileInfo info(filePath());
+  if( !info.exists() ) {
+    _haveMetadata = false;
+    return;
+  }
+  _metadata.mode         = priv::toMode(info.permissions());
+  _metadata.size         = uint64_t(info.size());
+  _metadata.lastModified = info.lastModified().toMSecsSinceEpoch();
+  _targetType = info.isDir()
+      ? FindType::Directory
+      : info.isFile()
+        ? FindType::File
+        : FindType::Other;
+#endif
+
+  _haveMetadata = true;
+}
@@ -0,0 +1,437 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <QtCore/QDir>
+#include <QtCore/QThread>
+
+#include "FindJob.h"
+
+#include "DirectoryReader.h"
+#include "FindEntry.h"
+#include "IgnoreRules.h"
+#include "LiveIndex.h"
+#include "TreeSnapshot.h"
+#include "VisitedDirectories.h"
+#include "WorkStealingQueue.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr int kBatchSize = 1024;
+
+constexpr std::chrono::milliseconds kBatchInterval{100};
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  struct Directory {
+    Directory() = default;
+
+    Directory(const std::string_view& _path, const IgnoreLevelPtr& _ignore,
+              const uint32_t _snapshotDir = TreeSnapshot::kNoDirectory)
+      : path(_path.data(), _path.size())
+      , ignore{_ignore}
+      , snapshotDir{_snapshotDir}
+    {
+    }
+
+    std::string path{};
+    IgnoreLevelPtr ignore{};
+    uint32_t snapshotDir{TreeSnapshot::kNoDirectory};
+  };
+
+  using DirectoryQueue = WorkStealingQueue<Directory>;
+
+  // NOTE: Collects a worker's results and hands them to the (shared) sink
+  //       once a batch is full or the batch's age exceeds kBatchInterval.
+  class ResultsBatch {
+  public:
+    ResultsBatch(const FindResultsSink& sink, std::mutex& mutex)
+      : _mutex(mutex)
+      , _sink(sink)
+    {
+      _batch.reserve(kBatchSize);
+    }
+
+    void append(const QString& filePath)
+    {
+      if( _batch.isEmpty() ) {
+        _started = std::chrono::steady_clock::now();
+      }
+      _batch.push_back(filePath);
+      if( _batch.size() >= kBatchSize ) {
+        flush();
+      }
+    }
+
+    void flush()
+    {
+      if( _batch.isEmpty() ) {
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _sink(_batch);
+      }
+      _batch.clear();
+    }
+
+    void flushExpired()
+    {
+      if( !_batch.isEmpty()  &&  std::chrono::steady_clock::now() - _started >= kBatchInterval ) {
+        flush();
+      }
+    }
+
+  private:
+    QStringList _batch;
+    std::mutex& _mutex;
+    const FindResultsSink& _sink;
+    std::chrono::steady_clock::time_point _started{};
+  };
+
+  // NOTE: Reads either the file system, a snapshot or a live index of it.
+  class EntryReader {
+  public:
+    EntryReader(const TreeSnapshot *snapshot, const LiveIndex *index)
+      : _snapshot(snapshot)
+      , _index(index)
+    {
+    }
+
+    uint32_t child() const
+    {
+      return _snapshot != nullptr
+          ? _snapshotReader.child()
+          : TreeSnapshot::kNoDirectory;
+    }
+
+    void close()
+    {
+      _reader.close();
+      _indexReader.close();
+      _snapshotReader.close();
+    }
+
+    // NOTE: Snapshots and indexes are trees; no directory is listed twice.
+    bool identity(DirectoryIdentity& id) const
+    {
+      return _snapshot == nullptr  &&  _index == nullptr  &&  _reader.identity(id);
+    }
+
+    bool next(FindEntry& entry)
+    {
+      if(        _index != nullptr ) {
+        return _indexReader.next(entry);
+      } else if( _snapshot != nullptr ) {
+        return _snapshotReader.next(entry);
+      }
+      return _reader.next(entry);
+    }
+
+    bool open(const Directory& dir, FindEntry& entry)
+    {
+      if(        _index != nullptr ) {
+        return _indexReader.open(_index, dir.path, entry);
+      } else if( _snapshot != nullptr ) {
+        return _snapshotReader.open(_snapshot, dir.snapshotDir, dir.path, entry);
+      }
+      return _reader.open(dir.path, entry);
+    }
+
+  private:
+    const TreeSnapshot *_snapshot{nullptr};
+    const LiveIndex *_index{nullptr};
+    DirectoryReader _reader;
+    IndexReader _indexReader;
+    SnapshotReader _snapshotReader;
+  };
+
+  // NOTE: Shared by all workers of a traversal; directories reached through
+  //       a symbolic link are collected for the next pass.
+  struct Visited {
+    VisitedDirectories directories;
+    uint64_t rootDevice{0};
+    std::vector<Directory> linked;
+    std::mutex linkedMutex;
+  };
+
+  uint64_t deviceOf(const std::string& dirPath)
+  {
+    DirectoryReader reader;
+    FindEntry entry;
+    DirectoryIdentity id;
+    return reader.open(dirPath, entry)  &&  reader.identity(id)
+        ? id.device
+        : 0;
+  }
+
+  bool needsMetadata(const FindJob& job)
+  {
+    for(const IFindFilterPtr& filter : job.filters) {
+      if( filter  &&  filter->needsMetadata() ) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int threadCount(const FindJob& job)
+  {
+    return job.numThreads > 0
+        ? job.numThreads
+        : qMax<int>(1, QThread::idealThreadCount());
+  }
+
+  bool isCanceled(const FindJob& job)
+  {
+    return job.cancel != nullptr  &&  job.cancel->load(std::memory_order_relaxed);
+  }
+
+  void findWorker(const FindJob& job, const TreeSnapshot *snapshot, const LiveIndex *index,
+                  DirectoryQueue& queue, Visited& visited, const int worker,
+                  const FindResultsSink& sink, std::mutex& sinkMutex, FindStatistics& stats)
+  {
+    const bool no_filter = !job.flags.testFlag(FindFlag::Directories)  &&  !job.flags.testFlag(FindFlag::Files);
+    const bool list_dirs  = no_filter  ||  job.flags.testFlag(FindFlag::Directories);
+    const bool list_files = no_filter  ||  job.flags.testFlag(FindFlag::Files);
+    const bool     follow = job.flags.testFlag(FindFlag::FollowSymlinks);
+    const bool    recurse = job.flags.testFlag(FindFlag::Subdirectories);
+    const bool use_ignore = job.flags.testFlag(FindFlag::IgnoreFiles);
+    const bool       xdev = job.flags.testFlag(FindFlag::SameFileSystem);
+
+    // NOTE: Filters are not required to be thread-safe; hence every worker uses its own copy!
+    FilterPipeline filters(job.filters);
+
+    ResultsBatch results(sink, sinkMutex);
+
+    EntryReader reader(snapshot, index);
+    FindEntry entry;
+
+    Directory dir;
+    while( queue.pop(worker, dir) ) {
+      // NOTE: A canceled traversal drains the queue without reading any further directory!
+      if( isCanceled(job)  ||  !reader.open(dir, entry) ) {
+        queue.done();
+        continue;
+      }
+
+      // NOTE: Every directory is read only once, no matter how many links
+      //       or mounts lead to it; this also breaks any cycle of links!
+      DirectoryIdentity id;
+      if( reader.identity(id) ) {
+        if( (xdev  &&  id.device != visited.rootDevice)  ||  !visited.directories.insert(id) ) {
+          stats.repeats++;
+          reader.close();
+          queue.done();
+          continue;
+        }
+      }
+
+      stats.directories++;
+
+      const IgnoreLevelPtr ignore = use_ignore
+          ? IgnoreLevel::create(dir.ignore, dir.path)
+          : IgnoreLevelPtr();
+
+      while( reader.next(entry) ) {
+        stats.entries++;
+
+        // NOTE: Entries neither being a directory nor a file (i.e. broken links) are skipped!
+        const bool  is_dir = entry.isDir();
+        const bool is_file = !is_dir  &&  entry.isFile();
+        if( !is_dir  &&  !is_file ) {
+          continue;
+        }
+
+        if( ignore  &&  ignore->isIgnored(entry) ) {
+          continue;
+        }
+
+        if( is_dir  &&  recurse  &&  !filters.pruned(entry) ) {
+          if(        !entry.isSymLink() ) {
+            queue.push(worker, Directory(entry.filePathView(), ignore, reader.child()));
+          } else if( follow ) {
+            std::lock_guard<std::mutex> lock(visited.linkedMutex);
+            visited.linked.emplace_back(entry.filePathView(), ignore, reader.child());
+          }
+        }
+
+        if( (is_dir  &&  !list_dirs)  ||  (is_file  &&  !list_files) ) {
+          continue;
+        }
+
+        if( filters.filtered(entry) ) {
+          continue;
+        }
+
+        results.append(entry.filePath());
+      }
+
+      results.flushExpired();
+
+      queue.done();
+    }
+
+    results.flush();
+
+    stats.filters = filters.statistics();
+  }
+
+} // namespace priv
+
+////// FindJob - public //////////////////////////////////////////////////////
+
+FindJob::FindJob(const QString& _rootPath, const FindFlags _flags) noexcept
+  : rootPath(_rootPath)
+  , flags{_flags}
+{
+}
+
+////// FindStatistics - public ///////////////////////////////////////////////
+
+FindStatistics& FindStatistics::operator+=(const FindStatistics& other)
+{
+  directories += other.directories;
+  entries     += other.entries;
+  repeats     += other.repeats;
+  if( filters.size() < other.filters.size() ) {
+    filters.resize(other.filters.size());
+  }
+  for(std::size_t i = 0; i < other.filters.size(); i++) {
+    if( filters[i].name == nullptr ) {
+      filters[i].name   = other.filters[i].name;
+      filters[i].reject = other.filters[i].reject;
+    }
+    filters[i] += other.filters[i];
+  }
+  return *this;
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+QStringList executeFind(const FindJob& job, FindStatistics *stats)
+{
+  QStringList results;
+  executeFind(job, [&](const QStringList& batch) -> void {
+    results.append(batch);
+  }, stats);
+  return results;
+}
+
+void executeFind(const FindJob& job, const FindResultsSink& sink, FindStatistics *stats)
+{
+  if( job.rootPath.isEmpty()  ||  !sink ) {
+    return;
+  }
+
+  // (1) Seed queue with root directory //////////////////////////////////////
+
+  const int numThreads = priv::threadCount(job);
+
+  const std::string rootPath = QDir(job.rootPath).absolutePath().toStdString();
+
+  // NOTE: Without a covering index or a valid snapshot, the file system is walked.
+  //       Neither follows links nor records devices; the metadata of a
+  //       snapshot's files may be outdated (cf. TreeSnapshot).
+  const bool use_tree = !job.flags.testFlag(FindFlag::FollowSymlinks)  &&
+      !job.flags.testFlag(FindFlag::SameFileSystem);
+
+  const LiveIndex *index = use_tree  &&  job.index != nullptr  &&  job.index->covers(rootPath)
+      ? job.index
+      : nullptr;
+
+  const bool use_snapshot = use_tree  &&  !priv::needsMetadata(job);
+  const TreeSnapshotPtr snapshot = index == nullptr  &&  use_snapshot  &&  !job.snapshotFile.isEmpty()
+      ? TreeSnapshot::update(job.snapshotFile, rootPath)
+      : TreeSnapshotPtr();
+
+  priv::Visited visited;
+  visited.rootDevice = priv::deviceOf(rootPath);
+  visited.linked.emplace_back(rootPath, job.flags.testFlag(FindFlag::IgnoreFiles)
+                              ? IgnoreLevel::createRoot(rootPath)
+                              : IgnoreLevelPtr(),
+                              snapshot ? TreeSnapshot::kRootDirectory : TreeSnapshot::kNoDirectory);
+
+  // (2) Traverse tree; the calling thread is worker #0 //////////////////////
+
+  // NOTE: Every pass walks the directories linked to by the previous pass;
+  //       hence a directory is listed by its real path, if the walk reaches
+  //       it by one. Which of several links to it is listed is not defined.
+
+  priv::DirectoryQueue queue(numThreads);
+
+  std::mutex sinkMutex;
+
+  std::vector<FindStatistics> workerStats(static_cast<std::size_t>(numThreads));
+
+  while( !visited.linked.empty()  &&  !priv::isCanceled(job) ) {
+    std::vector<priv::Directory> pass;
+    pass.swap(visited.linked);
+    for(priv::Directory& dir : pass) {
+      queue.push(0, std::move(dir));
+    }
+
+    std::vector<FindStatistics> passStats(static_cast<std::size_t>(numThreads));
+
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<std::size_t>(numThreads - 1));
+    for(int i = 1; i < numThreads; i++) {
+      threads.emplace_back(priv::findWorker, std::cref(job), snapshot.get(), index,
+                           std::ref(queue), std::ref(visited),
+                           i, std::cref(sink), std::ref(sinkMutex),
+                           std::ref(passStats[static_cast<std::size_t>(i)]));
+    }
+
+    priv::findWorker(job, snapshot.get(), index, queue, visited, 0, sink, sinkMutex, passStats[0]);
+
+    for(std::thread& thread : threads) {
+      thread.join();
+    }
+
+    for(std::size_t i = 0; i < passStats.size(); i++) {
+      workerStats[i] += passStats[i];
+    }
+  }
+
+  // (3) Merge statistics ////////////////////////////////////////////////////
+
+  if( stats != nullptr ) {
+    *stats = FindStatistics();
+    for(const FindStatistics& s : workerStats) {
+      *stats += s;
+    }
+  }
+}
@@ -0,0 +1,404 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "GlobSet.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr std::size_t kMaxFoldOnStack = 256;
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  constexpr char kSep = '/';
+
+  void fold(std::string& s)
+  {
+    std::transform(s.begin(), s.end(), s.begin(), foldAscii);
+  }
+
+  inline bool isSpace(const char c)
+  {
+    return c == ' '  ||  c == '\t';
+  }
+
+  inline bool isSpecial(const char c)
+  {
+    return c == '*'  ||  c == '?'  ||  c == '['  ||  c == '\\';
+  }
+
+  inline bool hasSpecial(const std::string_view& s)
+  {
+    return std::any_of(s.cbegin(), s.cend(), isSpecial);
+  }
+
+  // NOTE: Returns the position past the class or npos, if 'glob' is malformed.
+  std::string_view::size_type matchClass(const std::string_view& glob, std::string_view::size_type pos,
+                                         const char c, bool *match)
+  {
+    *match = false;
+
+    const bool negate = pos < glob.size()  &&  (glob[pos] == '!'  ||  glob[pos] == '^');
+    if( negate ) {
+      pos++;
+    }
+
+    bool first = true;
+    while( pos < glob.size() ) {
+      char lo = glob[pos];
+      if( lo == ']'  &&  !first ) {
+        *match = *match != negate;
+        return pos + 1;
+      }
+      first = false;
+
+      if( lo == '\\'  &&  pos + 1 < glob.size() ) {
+        lo = glob[++pos];
+      }
+      char hi = lo;
+      if( pos + 2 < glob.size()  &&  glob[pos + 1] == '-'  &&  glob[pos + 2] != ']' ) {
+        pos += 2;
+        hi = glob[pos];
+        if( hi == '\\'  &&  pos + 1 < glob.size() ) {
+          hi = glob[++pos];
+        }
+      }
+      pos++;
+
+      if( lo <= c  &&  c <= hi ) {
+        *match = true;
+      }
+    }
+
+    return std::string_view::npos;
+  }
+
+  // NOTE: Matches iteratively, remembering only the last '*' and the last
+  //       '**' to backtrack to; everything before them is never revisited,
+  //       as a later wildcard may absorb whatever an earlier one could.
+  //       Hence every wildcard costs at most one pass over 's'.
+  bool matchGlob(const std::string_view& glob, const std::string_view& s)
+  {
+    using size_type = std::string_view::size_type;
+
+    constexpr size_type npos = std::string_view::npos;
+
+    size_type g = 0;
+    size_type i = 0;
+    // '*' - Position past it and the next position of 's' to try
+    size_type starG = npos;
+    size_type starI = 0;
+    // '**' - Dito; with '**/', 's' is only tried after separators
+    size_type dstarG = npos;
+    size_type dstarI = 0;
+    bool dstarSep = false;
+
+    while( true ) {
+      if( g < glob.size() ) {
+        const char p = glob[g];
+
+        // (1) Record wildcards ////////////////////////////////////////////
+
+        if( p == '*'  &&  g + 1 < glob.size()  &&  glob[g + 1] == '*' ) {
+          g += 2;
+          if( g >= glob.size() ) {
+            return true;
+          }
+          dstarSep = glob[g] == kSep;
+          if( dstarSep ) {
+            g++;
+            // NOTE: '**/' also matches zero directories!
+            if( i > 0  &&  s[i - 1] != kSep ) {
+              const size_type sep = s.find(kSep, i);
+              if( sep == npos ) {
+                return false;
+              }
+              i = sep + 1;
+            }
+          }
+          dstarG = g;
+          dstarI = i;
+          starG  = npos;
+          continue;
+        }
+
+        if( p == '*' ) {
+          g++;
+          starG = g;
+          starI = i;
+          continue;
+        }
+
+        // (2) Match a single character ////////////////////////////////////
+
+        if( i < s.size() ) {
+          bool match = false;
+          size_type next = g + 1;
+
+          if(        p == '?' ) {
+            match = s[i] != kSep;
+
+          } else if( p == '[' ) {
+            next = matchClass(glob, g + 1, s[i], &match);
+            if( next == npos ) { // Malformed: match literally
+              match = s[i] == p;
+              next = g + 1;
+            } else {
+              match = match  &&  s[i] != kSep;
+            }
+
+          } else {
+            size_type lit = g;
+            if( p == '\\'  &&  g + 1 < glob.size() ) {
+              lit++;
+            }
+            match = s[i] == glob[lit];
+            next = lit + 1;
+
+          }
+
+          if( match ) {
+            g = next;
+            i++;
+            continue;
+          }
+        }
+
+      } else if( i == s.size() ) {
+        return true;
+      }
+
+      // (3) Backtrack; '*' never consumes a separator /////////////////////
+
+      if( starG != npos  &&  starI < s.size()  &&  s[starI] != kSep ) {
+        starI++;
+        g = starG;
+        i = starI;
+        continue;
+      }
+      starG = npos;
+
+      if( dstarG != npos  &&  dstarI < s.size() ) {
+        if( dstarSep ) {
+          const size_type sep = s.find(kSep, dstarI);
+          if( sep == npos ) {
+            return false;
+          }
+          dstarI = sep + 1;
+        } else {
+          dstarI++;
+        }
+        g = dstarG;
+        i = dstarI;
+        continue;
+      }
+
+      return false;
+    }
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+GlobSet::GlobSet(const bool caseInsensitive)
+  : _caseInsensitive{caseInsensitive}
+{
+}
+
+bool GlobSet::add(const std::string_view& _glob)
+{
+  if( _glob.empty() ) {
+    return false;
+  }
+
+  std::string folded;
+  if( _caseInsensitive ) {
+    folded.assign(_glob.data(), _glob.size());
+    priv::fold(folded);
+  }
+  const std::string_view glob = _caseInsensitive
+      ? std::string_view(folded)
+      : _glob;
+
+  const int index = _count++;
+
+  // (1) Literal /////////////////////////////////////////////////////////////
+
+  if( !priv::hasSpecial(glob) ) {
+    _literals.insert(glob, index);
+    return true;
+  }
+
+  // (2) '*suffix' ///////////////////////////////////////////////////////////
+
+  const std::string_view suffix = glob.substr(1);
+  if( glob.front() == '*'  &&  !suffix.empty()  &&
+      !priv::hasSpecial(suffix)  &&  suffix.find(priv::kSep) == std::string_view::npos ) {
+    _suffixes.insert(suffix, index);
+    return true;
+  }
+
+  // (3) 'prefix*' ///////////////////////////////////////////////////////////
+
+  const std::string_view prefix = glob.substr(0, glob.size() - 1);
+  if( glob.back() == '*'  &&  !prefix.empty()  &&  !priv::hasSpecial(prefix) ) {
+    _prefixes.insert(prefix, index);
+    return true;
+  }
+
+  // (4) Anything else ///////////////////////////////////////////////////////
+
+  _globs.emplace_back(glob, index);
+
+  return true;
+}
+
+// NOTE: Surrounding white space is stripped from every glob.
+int GlobSet::addList(const std::string_view& globs, const char sep)
+{
+  int result = 0;
+
+  std::string_view::size_type pos = 0;
+  while( pos <= globs.size() ) {
+    std::string_view::size_type end = globs.find(sep, pos);
+    if( end == std::string_view::npos ) {
+      end = globs.size();
+    }
+
+    std::string_view glob = globs.substr(pos, end - pos);
+    while( !glob.empty()  &&  priv::isSpace(glob.front()) ) {
+      glob.remove_prefix(1);
+    }
+    while( !glob.empty()  &&  priv::isSpace(glob.back()) ) {
+      glob.remove_suffix(1);
+    }
+
+    if( add(glob) ) {
+      result++;
+    }
+
+    pos = end + 1;
+  }
+
+  return result;
+}
+
+void GlobSet::clear()
+{
+  _count = 0;
+  _literals.clear();
+  _prefixes.clear();
+  _suffixes.clear();
+  _globs.clear();
+}
+
+int GlobSet::count() const
+{
+  return _count;
+}
+
+bool GlobSet::isCaseInsensitive() const
+{
+  return _caseInsensitive;
+}
+
+bool GlobSet::isEmpty() const
+{
+  return _count < 1;
+}
+
+int GlobSet::lastMatch(const std::string_view& s) const
+{
+  if( !_caseInsensitive ) {
+    return lastMatchFolded(s);
+  }
+
+  // NOTE: Typical names are folded without any allocation.
+  if( s.size() <= kMaxFoldOnStack ) {
+    char buffer[kMaxFoldOnStack];
+    std::transform(s.cbegin(), s.cend(), buffer, foldAscii);
+    return lastMatchFolded(std::string_view(buffer, s.size()));
+  }
+
+  std::string folded(s.data(), s.size());
+  priv::fold(folded);
+  return lastMatchFolded(folded);
+}
+
+bool GlobSet::matches(const std::string_view& s) const
+{
+  return lastMatch(s) >= 0;
+}
+
+bool GlobSet::isMatch(const std::string_view& glob, const std::string_view& s)
+{
+  return priv::matchGlob(glob, s);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+GlobSet::Glob::Glob(const std::string_view& _pattern, const int _index)
+  : pattern(_pattern.data(), _pattern.size())
+  , index{_index}
+{
+}
+
+int GlobSet::lastMatchFolded(const std::string_view& s) const
+{
+  int result = _literals.lookup(s);
+
+  // NOTE: '*' does not match the separator; hence the remainder of 's' must
+  //       not contain any separator!
+  const std::string_view::size_type sep = s.find(priv::kSep);
+  if( sep == std::string_view::npos ) {
+    result = std::max<int>(result, _suffixes.lookupSuffix(s));
+  }
+
+  const std::string_view::size_type last = s.rfind(priv::kSep);
+  for(const KeyMap::size_type size : _prefixes.keySizes()) {
+    if( size > s.size()  ||  (last != std::string_view::npos  &&  last >= size) ) {
+      continue;
+    }
+    result = std::max<int>(result, _prefixes.lookup(s.substr(0, size)));
+  }
+
+  for(const Glob& glob : _globs) {
+    if( glob.index > result  &&  priv::matchGlob(glob.pattern, s) ) {
+      result = glob.index;
+    }
+  }
+
+  return result;
+}
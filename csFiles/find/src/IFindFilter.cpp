@@ -37,14 +37,40 @@ IFindFilter::~IFindFilter()
 {
 }
 
-bool IFindFilter::filtered(const QFileInfo& info) const
+bool IFindFilter::active() const
+{
+  return isActive();
+}
+
+bool IFindFilter::filtered(const FindEntry& entry) const
 {
   if( !isActive() ) {
     return false;
   }
   return isReject()
-      ? isMatch(info)   // Reject: filter out if matching
-      : !isMatch(info); // Accept: filter out if not matching
+      ? isMatch(entry)   // Reject: filter out if matching
+      : !isMatch(entry); // Accept: filter out if not matching
+}
+
+bool IFindFilter::isReject() const
+{
+  return _reject;
+}
+
+// NOTE: Filters requiring an entry's metadata are evaluated last.
+bool IFindFilter::needsMetadata() const
+{
+  return false;
+}
+
+// NOTE: A pruned directory's subtree is not traversed at all;
+//       the directory itself is still subject to filtered()!
+bool IFindFilter::pruned(const FindEntry& dir) const
+{
+  if( !isActive() ) {
+    return false;
+  }
+  return isPrunable(dir);
 }
 
 ////// protected /////////////////////////////////////////////////////////////
@@ -54,7 +80,7 @@ IFindFilter::IFindFilter(const bool reject)
 {
 }
 
-bool IFindFilter::isReject() const
+bool IFindFilter::isPrunable(const FindEntry& /*dir*/) const
 {
-  return _reject;
+  return false;
 }
@@ -0,0 +1,271 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdlib>
+
+#include <algorithm>
+
+#include <QtCore/QFile>
+
+#include "IgnoreRules.h"
+
+#include "FindEntry.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  inline bool isSpace(const char c)
+  {
+    return c == ' '  ||  c == '\t'  ||  c == '\r';
+  }
+
+  std::string_view trimmed(std::string_view line)
+  {
+    while( !line.empty()  &&  isSpace(line.back()) ) {
+      // NOTE: An escaped trailing space is kept.
+      if( line.size() > 1  &&  line[line.size() - 2] == '\\' ) {
+        break;
+      }
+      line.remove_suffix(1);
+    }
+    return line;
+  }
+
+  std::string globalExcludesFile()
+  {
+    const char *config = std::getenv("XDG_CONFIG_HOME");
+    if( config != nullptr  &&  *config != '\0' ) {
+      return std::string(config) + "/git/ignore";
+    }
+    const char *home = std::getenv("HOME");
+    if( home != nullptr  &&  *home != '\0' ) {
+      return std::string(home) + "/.config/git/ignore";
+    }
+    return std::string();
+  }
+
+} // namespace priv
+
+////// IgnoreRules - public //////////////////////////////////////////////////
+
+void IgnoreRules::addRule(std::string_view line)
+{
+  line = priv::trimmed(line);
+  if( line.empty()  ||  line.front() == '#' ) {
+    return;
+  }
+
+  // (1) Negation ////////////////////////////////////////////////////////////
+
+  bool negate = false;
+  if(        line.front() == '!' ) {
+    negate = true;
+    line.remove_prefix(1);
+  } else if( line.size() > 1  &&  line[0] == '\\'  &&  (line[1] == '!'  ||  line[1] == '#') ) {
+    line.remove_prefix(1);
+  }
+
+  // (2) Directories only ////////////////////////////////////////////////////
+
+  bool dirOnly = false;
+  if( !line.empty()  &&  line.back() == '/' ) {
+    dirOnly = true;
+    line.remove_suffix(1);
+  }
+
+  // (3) Anchored to the directory of the ignore file ////////////////////////
+
+  const bool anchored = line.find('/') != std::string_view::npos;
+  if( !line.empty()  &&  line.front() == '/' ) {
+    line.remove_prefix(1);
+  }
+
+  if( line.empty() ) {
+    return;
+  }
+
+  const SetIndex set = anchored
+      ? (dirOnly ? DirPaths : Paths)
+      : (dirOnly ? DirNames : Names);
+
+  _sets[set].add(line);
+  _order[set].push_back(static_cast<int>(_negate.size()));
+  _negate.push_back(negate);
+}
+
+bool IgnoreRules::isEmpty() const
+{
+  return _negate.empty();
+}
+
+bool IgnoreRules::load(const std::string& filename)
+{
+  QFile file(QString::fromStdString(filename));
+  if( !file.open(QIODevice::ReadOnly) ) {
+    return false;
+  }
+
+  const QByteArray text = file.readAll();
+  parse(std::string_view(text.constData(), static_cast<std::size_t>(text.size())));
+
+  return true;
+}
+
+IgnoreRules::Match IgnoreRules::match(const std::string_view& relPath, const bool isDir) const
+{
+  const std::string_view::size_type sep = relPath.rfind('/');
+  const std::string_view name = sep != std::string_view::npos
+      ? relPath.substr(sep + 1)
+      : relPath;
+
+  int order = std::max<int>(lastMatch(Names, name), lastMatch(Paths, relPath));
+  if( isDir ) {
+    order = std::max<int>(order, lastMatch(DirNames, name));
+    order = std::max<int>(order, lastMatch(DirPaths, relPath));
+  }
+
+  if( order < 0 ) {
+    return Match::None;
+  }
+
+  return _negate[static_cast<std::size_t>(order)]
+      ? Match::Whitelist
+      : Match::Ignore;
+}
+
+void IgnoreRules::parse(const std::string_view& text)
+{
+  std::string_view::size_type pos = 0;
+  while( pos < text.size() ) {
+    std::string_view::size_type end = text.find('\n', pos);
+    if( end == std::string_view::npos ) {
+      end = text.size();
+    }
+    addRule(text.substr(pos, end - pos));
+    pos = end + 1;
+  }
+}
+
+////// IgnoreRules - private /////////////////////////////////////////////////
+
+int IgnoreRules::lastMatch(const SetIndex set, const std::string_view& s) const
+{
+  const int index = _sets[set].lastMatch(s);
+  return index >= 0
+      ? _order[set][static_cast<std::size_t>(index)]
+      : -1;
+}
+
+////// IgnoreLevel - public //////////////////////////////////////////////////
+
+IgnoreLevel::~IgnoreLevel()
+{
+}
+
+bool IgnoreLevel::isIgnored(const FindEntry& entry) const
+{
+  const bool isDir = entry.isDir();
+  for(const IgnoreLevel *level = this; level != nullptr; level = level->_parent.get()) {
+    const IgnoreRules::Match m = level->match(entry.filePathView(), isDir);
+    if( m != IgnoreRules::Match::None ) {
+      return m == IgnoreRules::Match::Ignore;
+    }
+  }
+  return false;
+}
+
+// NOTE: Returns 'parent' if 'dirPath' holds no ignore files.
+IgnoreLevelPtr IgnoreLevel::create(const IgnoreLevelPtr& parent, const std::string& dirPath)
+{
+  std::unique_ptr<IgnoreLevel> level(new IgnoreLevel(parent, dirPath));
+
+  for(const char *name : {"/.ignore", "/.gitignore"}) {
+    IgnoreRules rules;
+    if( rules.load(dirPath + name)  &&  !rules.isEmpty() ) {
+      level->_rules.push_back(std::move(rules));
+    }
+  }
+
+  if( level->_rules.empty() ) {
+    return parent;
+  }
+
+  return IgnoreLevelPtr(level.release());
+}
+
+// NOTE: The root level holds the repository's and the user's excludes;
+//       the root directory's own ignore files are read by create().
+IgnoreLevelPtr IgnoreLevel::createRoot(const std::string& rootPath)
+{
+  std::unique_ptr<IgnoreLevel> level(new IgnoreLevel(IgnoreLevelPtr(), rootPath));
+
+  for(const std::string& filename : {rootPath + "/.git/info/exclude", priv::globalExcludesFile()}) {
+    IgnoreRules rules;
+    if( !filename.empty()  &&  rules.load(filename)  &&  !rules.isEmpty() ) {
+      level->_rules.push_back(std::move(rules));
+    }
+  }
+
+  if( level->_rules.empty() ) {
+    return IgnoreLevelPtr();
+  }
+
+  return IgnoreLevelPtr(level.release());
+}
+
+////// IgnoreLevel - private /////////////////////////////////////////////////
+
+IgnoreLevel::IgnoreLevel(const IgnoreLevelPtr& parent, const std::string& dirPath)
+  : _base(dirPath)
+  , _parent(parent)
+{
+  if( _base.empty()  ||  _base.back() != '/' ) {
+    _base.push_back('/');
+  }
+}
+
+IgnoreRules::Match IgnoreLevel::match(const std::string_view& filePath, const bool isDir) const
+{
+  if( filePath.substr(0, _base.size()) != _base ) {
+    return IgnoreRules::Match::None;
+  }
+
+  const std::string_view relPath = filePath.substr(_base.size());
+  for(const IgnoreRules& rules : _rules) {
+    const IgnoreRules::Match m = rules.match(relPath, isDir);
+    if( m != IgnoreRules::Match::None ) {
+      return m;
+    }
+  }
+
+  return IgnoreRules::Match::None;
+}
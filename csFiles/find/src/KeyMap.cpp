@@ -0,0 +1,112 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <functional>
+
+#include "KeyMap.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+void KeyMap::clear()
+{
+  _arena.clear();
+  _entries.clear();
+  _keySizes.clear();
+}
+
+bool KeyMap::isEmpty() const
+{
+  return _entries.empty();
+}
+
+void KeyMap::insert(const std::string_view& key, const int index)
+{
+  const std::size_t hash = std::hash<std::string_view>()(key);
+
+  const std::pair<Entries::iterator,Entries::iterator> range = _entries.equal_range(hash);
+  for(Entries::iterator it = range.first; it != range.second; ++it) {
+    Entry& entry = it->second;
+    if( std::string_view(_arena).substr(entry.offset, entry.size) == key ) {
+      entry.index = std::max<int>(entry.index, index);
+      return;
+    }
+  }
+
+  _entries.emplace(hash, Entry{_arena.size(), key.size(), index});
+  _arena.append(key.data(), key.size());
+
+  if( std::find(_keySizes.cbegin(), _keySizes.cend(), key.size()) == _keySizes.cend() ) {
+    _keySizes.push_back(key.size());
+  }
+}
+
+const std::vector<KeyMap::size_type>& KeyMap::keySizes() const
+{
+  return _keySizes;
+}
+
+int KeyMap::lookup(const std::string_view& key) const
+{
+  const std::size_t hash = std::hash<std::string_view>()(key);
+
+  const std::pair<Entries::const_iterator,Entries::const_iterator> range = _entries.equal_range(hash);
+  for(Entries::const_iterator it = range.first; it != range.second; ++it) {
+    const Entry& entry = it->second;
+    if( std::string_view(_arena).substr(entry.offset, entry.size) == key ) {
+      return entry.index;
+    }
+  }
+
+  return -1;
+}
+
+int KeyMap::lookupPrefix(const std::string_view& s) const
+{
+  int result = -1;
+  for(const size_type size : _keySizes) {
+    if( size <= s.size() ) {
+      result = std::max<int>(result, lookup(s.substr(0, size)));
+    }
+  }
+  return result;
+}
+
+int KeyMap::lookupSuffix(const std::string_view& s) const
+{
+  int result = -1;
+  for(const size_type size : _keySizes) {
+    if( size <= s.size() ) {
+      result = std::max<int>(result, lookup(s.substr(s.size() - size)));
+    }
+  }
+  return result;
+}
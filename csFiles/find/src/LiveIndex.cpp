@@ -0,0 +1,472 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QtGlobal>
+
+#ifdef Q_OS_LINUX
+# include <fcntl.h>
+# include <poll.h>
+# include <sys/eventfd.h>
+# include <sys/inotify.h>
+# include <sys/stat.h>
+# include <unistd.h>
+
+# include <cerrno>
+#endif
+
+#include <mutex>
+
+#include "DirectoryReader.h"
+
+#include "LiveIndex.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr std::size_t kEventBufferSize = 64*1024;
+
+#ifdef Q_OS_LINUX
+constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_DELETE_SELF |
+    IN_MOVE_SELF | IN_MOVED_FROM | IN_MOVED_TO |
+    IN_DONT_FOLLOW | IN_EXCL_UNLINK | IN_ONLYDIR;
+#endif
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  bool isBelowOrEqual(const std::string& path, const std::string& root)
+  {
+    if( root.empty()  ||  path.compare(0, root.size(), root) != 0 ) {
+      return false;
+    }
+    return path.size() == root.size()  ||  root.back() == '/'  ||  path[root.size()] == '/';
+  }
+
+  std::string joinPath(const std::string& dirPath, const std::string_view& name)
+  {
+    std::string result(dirPath);
+    if( result.empty()  ||  result.back() != '/' ) {
+      result.push_back('/');
+    }
+    result.append(name.data(), name.size());
+    return result;
+  }
+
+#ifdef Q_OS_LINUX
+  FindType lstatType(const std::string& path)
+  {
+    struct stat buf;
+    if( ::lstat(path.c_str(), &buf) != 0 ) {
+      return FindType::Unknown;
+    }
+    if(        S_ISDIR(buf.st_mode) ) {
+      return FindType::Directory;
+    } else if( S_ISREG(buf.st_mode) ) {
+      return FindType::File;
+    } else if( S_ISLNK(buf.st_mode) ) {
+      return FindType::SymLink;
+    }
+    return FindType::Other;
+  }
+#endif
+
+} // namespace priv
+
+////// LiveIndex - public ////////////////////////////////////////////////////
+
+LiveIndex::~LiveIndex()
+{
+  stop();
+}
+
+bool LiveIndex::covers(const std::string& dirPath) const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return _complete  &&  priv::isBelowOrEqual(dirPath, _rootPath);
+}
+
+bool LiveIndex::list(const std::string& dirPath, Listing& entries) const
+{
+  entries.clear();
+
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  if( !_complete ) {
+    return false;
+  }
+
+  const auto dir = _dirs.find(dirPath);
+  if( dir == _dirs.cend() ) {
+    return false;
+  }
+
+  entries.reserve(dir->second.entries.size());
+  for(const auto& entry : dir->second.entries) {
+    entries.emplace_back(entry.first, entry.second);
+  }
+
+  return true;
+}
+
+std::string LiveIndex::rootPath() const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return _rootPath;
+}
+
+bool LiveIndex::watch(const std::string& rootPath)
+{
+  stop();
+
+#ifdef Q_OS_LINUX
+  if( rootPath.empty()  ||  rootPath.front() != '/' ) {
+    return false;
+  }
+
+  _fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if( _fd < 0 ) {
+    return false;
+  }
+
+  _stopFd = ::eventfd(0, EFD_CLOEXEC);
+  if( _stopFd < 0 ) {
+    stop();
+    return false;
+  }
+
+  {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _rootPath = rootPath;
+    while( _rootPath.size() > 1  &&  _rootPath.back() == '/' ) {
+      _rootPath.pop_back();
+    }
+  }
+
+  _thread = std::thread(&LiveIndex::run, this);
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+void LiveIndex::stop()
+{
+#ifdef Q_OS_LINUX
+  if( _thread.joinable() ) {
+    const uint64_t one = 1;
+    if( ::write(_stopFd, &one, sizeof(one)) == sizeof(one) ) {
+      _thread.join();
+    } else {
+      _thread.detach(); // Must never happen!
+    }
+  }
+
+  if( _fd >= 0 ) {
+    ::close(_fd);
+  }
+  _fd = -1;
+
+  if( _stopFd >= 0 ) {
+    ::close(_stopFd);
+  }
+  _stopFd = -1;
+#endif
+
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  _rootPath.clear();
+  _dirs.clear();
+  _watches.clear();
+  _complete = false;
+}
+
+LiveIndex *LiveIndex::global()
+{
+  static LiveIndex index;
+  return &index;
+}
+
+////// LiveIndex - private ///////////////////////////////////////////////////
+
+#ifdef Q_OS_LINUX
+
+// NOTE: Every directory is watched before it is read; hence no entry is
+//       missed, although some may be reported twice. Returns false if a
+//       directory could not be watched for lack of resources.
+bool LiveIndex::addTree(const std::string& dirPath)
+{
+  bool result = true;
+
+  std::vector<std::string> pending{dirPath};
+  while( !pending.empty() ) {
+    const std::string path = std::move(pending.back());
+    pending.pop_back();
+
+    const int wd = ::inotify_add_watch(_fd, path.c_str(), kWatchMask);
+    if( wd < 0 ) {
+      // NOTE: Vanished or unreadable directories are not listed by a find either!
+      if( errno != ENOENT  &&  errno != ENOTDIR  &&  errno != EACCES ) {
+        result = false;
+      }
+      continue;
+    }
+
+    Directory dir;
+    dir.wd = wd;
+
+    DirectoryReader reader;
+    FindEntry entry;
+    if( reader.open(path, entry) ) {
+      while( reader.next(entry) ) {
+        const FindType type = entry.isSymLink()
+            ? FindType::SymLink
+            : entry.type();
+        dir.entries.emplace(std::string(entry.fileNameView()), type);
+        if( type == FindType::Directory ) {
+          pending.push_back(std::string(entry.filePathView()));
+        }
+      }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _watches[wd] = path;
+    _dirs[path] = std::move(dir);
+  }
+
+  return result;
+}
+
+void LiveIndex::handleEvents(const char *data, const long size)
+{
+  std::vector<std::string> created;
+  bool overflow = false;
+
+  {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+
+    for(long pos = 0; pos < size; ) {
+      const struct inotify_event *event =
+          reinterpret_cast<const struct inotify_event*>(data + pos);
+      pos += long(sizeof(struct inotify_event) + event->len);
+
+      if( (event->mask & IN_Q_OVERFLOW) != 0 ) {
+        overflow = true;
+        continue;
+      }
+
+      const auto watch = _watches.find(event->wd);
+      if( watch == _watches.end() ) {
+        continue;
+      }
+
+      // (1) Events of the watched directory itself //////////////////////////
+
+      if( (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) != 0 ) {
+        if( watch->second == _rootPath ) {
+          _complete = false;
+        }
+        if( (event->mask & IN_IGNORED) != 0 ) {
+          _watches.erase(watch);
+        }
+        continue;
+      }
+
+      if( event->len < 1  ||  event->name[0] == '.'  ||  event->name[0] == '\0' ) {
+        continue;
+      }
+
+      // (2) Events of the directory's entries ///////////////////////////////
+
+      const auto dir = _dirs.find(watch->second);
+      if( dir == _dirs.end() ) {
+        continue;
+      }
+
+      const std::string name(event->name);
+      const std::string path = priv::joinPath(dir->first, name);
+
+      if(        (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0 ) {
+        const FindType type = priv::lstatType(path);
+        dir->second.entries[name] = type;
+        if( type == FindType::Directory ) {
+          created.push_back(path);
+        }
+
+      } else if( (event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0 ) {
+        const auto node = dir->second.entries.find(name);
+        if( node != dir->second.entries.end() ) {
+          const bool is_dir = node->second == FindType::Directory;
+          dir->second.entries.erase(node);
+          if( is_dir ) {
+            removeTree(path);
+          }
+        }
+
+      }
+    }
+  }
+
+  // NOTE: New directories are read without holding the lock.
+  for(const std::string& path : created) {
+    if( !addTree(path) ) {
+      std::unique_lock<std::shared_mutex> lock(_mutex);
+      _complete = false;
+    }
+  }
+
+  if( overflow ) {
+    rescan();
+  }
+}
+
+// NOTE: Expects the lock to be held!
+void LiveIndex::removeTree(const std::string& dirPath)
+{
+  std::vector<std::string> pending{dirPath};
+  while( !pending.empty() ) {
+    const std::string path = std::move(pending.back());
+    pending.pop_back();
+
+    const auto dir = _dirs.find(path);
+    if( dir == _dirs.end() ) {
+      continue;
+    }
+
+    for(const auto& entry : dir->second.entries) {
+      if( entry.second == FindType::Directory ) {
+        pending.push_back(priv::joinPath(path, entry.first));
+      }
+    }
+
+    ::inotify_rm_watch(_fd, dir->second.wd);
+    _watches.erase(dir->second.wd);
+    _dirs.erase(dir);
+  }
+}
+
+// NOTE: Events were lost; the whole tree is read again.
+void LiveIndex::rescan()
+{
+  std::string rootPath;
+  {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    for(const auto& watch : _watches) {
+      ::inotify_rm_watch(_fd, watch.first);
+    }
+    _dirs.clear();
+    _watches.clear();
+    _complete = false;
+    rootPath = _rootPath;
+  }
+
+  const bool complete = addTree(rootPath);
+
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  _complete = complete  &&  _dirs.count(rootPath) > 0;
+}
+
+void LiveIndex::run()
+{
+  rescan();
+
+  std::vector<char> buffer(kEventBufferSize);
+
+  struct pollfd fds[2];
+  fds[0].fd     = _fd;
+  fds[0].events = POLLIN;
+  fds[1].fd     = _stopFd;
+  fds[1].events = POLLIN;
+
+  while( true ) {
+    fds[0].revents = fds[1].revents = 0;
+    if( ::poll(fds, 2, -1) < 0 ) {
+      if( errno == EINTR ) {
+        continue;
+      }
+      break;
+    }
+
+    if( fds[1].revents != 0 ) {
+      break;
+    }
+
+    if( (fds[0].revents & POLLIN) == 0 ) {
+      continue;
+    }
+
+    long numRead;
+    while( (numRead = long(::read(_fd, buffer.data(), buffer.size()))) > 0 ) {
+      handleEvents(buffer.data(), numRead);
+    }
+  }
+}
+
+#endif
+
+////// IndexReader - public //////////////////////////////////////////////////
+
+void IndexReader::close()
+{
+  _entries.clear();
+  _pos = 0;
+  _open = false;
+}
+
+bool IndexReader::isOpen() const
+{
+  return _open;
+}
+
+bool IndexReader::next(FindEntry& entry)
+{
+  if( !_open  ||  _pos >= _entries.size() ) {
+    close();
+    return false;
+  }
+
+  const LiveIndex::Listing::value_type& e = _entries[_pos++];
+  entry.setName(e.first, e.second);
+
+  return true;
+}
+
+bool IndexReader::open(const LiveIndex *index, const std::string& dirPath, FindEntry& entry)
+{
+  close();
+
+  if( index == nullptr  ||  !index->list(dirPath, _entries) ) {
+    return false;
+  }
+
+  _open = true;
+  entry.setDirectory(dirPath);
+
+  return true;
+}
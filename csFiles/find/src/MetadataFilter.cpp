@@ -0,0 +1,143 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "MetadataFilter.h"
+
+////// MetadataCriteria - public /////////////////////////////////////////////
+
+bool MetadataCriteria::isActive() const
+{
+  return requiredFields() != 0  ||  type != FindType::Unknown;
+}
+
+unsigned MetadataCriteria::requiredFields() const
+{
+  unsigned result = 0;
+  if( minSize >= 0  ||  maxSize >= 0 ) {
+    result |= FindMetadata::Size;
+  }
+  if( modifiedAfter != 0  ||  modifiedBefore != 0 ) {
+    result |= FindMetadata::LastModified;
+  }
+  if( permissions != 0 ) {
+    result |= FindMetadata::Mode;
+  }
+  return result;
+}
+
+////// MetadataFilter - public ///////////////////////////////////////////////
+
+MetadataFilter::~MetadataFilter()
+{
+}
+
+IFindFilterPtr MetadataFilter::clone() const
+{
+  return IFindFilterPtr(new MetadataFilter(*this));
+}
+
+const char *MetadataFilter::name() const
+{
+  return "metadata";
+}
+
+bool MetadataFilter::needsMetadata() const
+{
+  return _fields != 0;
+}
+
+IFindFilterPtr MetadataFilter::create(const MetadataCriteria& criteria)
+{
+  return IFindFilterPtr(new MetadataFilter(criteria));
+}
+
+////// MetadataFilter - protected ////////////////////////////////////////////
+
+bool MetadataFilter::isActive() const
+{
+  return _criteria.isActive();
+}
+
+bool MetadataFilter::isMatch(const FindEntry& entry) const
+{
+  // (1) Type; without any stat() for most entries ///////////////////////////
+
+  if(        _criteria.type == FindType::SymLink ) {
+    if( !entry.isSymLink() ) {
+      return false;
+    }
+  } else if( _criteria.type != FindType::Unknown ) {
+    if( entry.type() != _criteria.type ) {
+      return false;
+    }
+  }
+
+  if( _fields == 0 ) {
+    return true;
+  }
+
+  // (2) Metadata; all required fields are fetched at once ///////////////////
+
+  const FindMetadata& meta = entry.metadata(_fields);
+  if( !entry.hasMetadata() ) {
+    return false;
+  }
+
+  const int64_t size = static_cast<int64_t>(meta.size);
+  if( _criteria.minSize >= 0  &&  size < _criteria.minSize ) {
+    return false;
+  }
+  if( _criteria.maxSize >= 0  &&  size > _criteria.maxSize ) {
+    return false;
+  }
+
+  if( _criteria.modifiedAfter != 0  &&  meta.lastModified < _criteria.modifiedAfter ) {
+    return false;
+  }
+  if( _criteria.modifiedBefore != 0  &&  meta.lastModified > _criteria.modifiedBefore ) {
+    return false;
+  }
+
+  if( (meta.mode & _criteria.permissions) != _criteria.permissions ) {
+    return false;
+  }
+
+  return true;
+}
+
+////// MetadataFilter - private //////////////////////////////////////////////
+
+MetadataFilter::MetadataFilter(const MetadataCriteria& criteria)
+  : IFindFilter(false)
+  , _criteria(criteria)
+  , _fields{criteria.requiredFields()}
+{
+}
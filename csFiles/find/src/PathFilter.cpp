@@ -29,10 +29,9 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <QtCore/QFileInfo>
-
 #include "PathFilter.h"
 
+#include "FindEntry.h"
 #include "PatternList.h"
 
 ////// public ////////////////////////////////////////////////////////////////
@@ -41,6 +40,16 @@ PathFilter::~PathFilter()
 {
 }
 
+IFindFilterPtr PathFilter::clone() const
+{
+  return IFindFilterPtr(new PathFilter(*this));
+}
+
+const char *PathFilter::name() const
+{
+  return "path";
+}
+
 IFindFilterPtr PathFilter::create(const QString& paths, const bool reject)
 {
   return IFindFilterPtr(new PathFilter(paths, reject));
@@ -53,14 +62,21 @@ bool PathFilter::isActive() const
   return !_paths.isEmpty();
 }
 
-bool PathFilter::isMatch(const QFileInfo& info) const
+bool PathFilter::isMatch(const FindEntry& entry) const
 {
-  for(const QString& path : _paths) {
-    if( info.absolutePath().contains(path, Qt::CaseInsensitive) ) {
-      return true;
-    }
+  // NOTE: All entries of a directory share the same path!
+  if( entry.directoryId() == 0  ||  entry.directoryId() != _cachedDirectoryId ) {
+    _cachedDirectoryId = entry.directoryId();
+    _cachedMatch = _paths.containsAny(entry.pathView());
   }
-  return false;
+  return _cachedMatch;
+}
+
+bool PathFilter::isPrunable(const FindEntry& dir) const
+{
+  // NOTE: Every path below 'dir' starts with dir's file path; if that already
+  //       contains a rejected fragment, all of the subtree is rejected, too!
+  return isReject()  &&  _paths.containsAny(dir.filePathView());
 }
 
 ////// private ///////////////////////////////////////////////////////////////
@@ -68,5 +84,9 @@ bool PathFilter::isMatch(const QFileInfo& info) const
 PathFilter::PathFilter(const QString& paths, const bool reject)
   : IFindFilter(reject)
 {
-  _paths = preparePatternList(paths);
+  std::vector<std::string> patterns;
+  for(const QString& path : preparePatternList(paths)) {
+    patterns.push_back(path.toStdString());
+  }
+  _paths = AhoCorasick(patterns, true);
 }
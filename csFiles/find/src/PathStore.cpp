@@ -0,0 +1,283 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+#include "PathStore.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr FileId kNoParent = std::numeric_limits<FileId>::max();
+
+constexpr std::size_t kMaxComponent = std::numeric_limits<uint16_t>::max();
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  inline std::size_t hashComponent(const FileId parent, const std::string_view& name)
+  {
+    return std::hash<std::string_view>()(name) ^ (std::size_t(parent)*std::size_t(0x9E3779B97F4A7C15));
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+QString PathStore::filePath(const FileId id) const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return QString::fromStdString(filePathUtf8(id, kNoParent));
+}
+
+QString PathStore::fileName(const FileId id) const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  if( id >= _nodes.size() ) {
+    return QString();
+  }
+  const std::string_view s = name(_nodes[id]);
+  return QString::fromUtf8(s.data(), static_cast<int>(s.size()));
+}
+
+QStringList PathStore::filePaths(const FileIds& ids) const
+{
+  QStringList result;
+  result.reserve(static_cast<int>(ids.size()));
+
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  for(const FileId id : ids) {
+    result.push_back(QString::fromStdString(filePathUtf8(id, kNoParent)));
+  }
+
+  return result;
+}
+
+FileId PathStore::insert(const QString& filePath)
+{
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  return insertPath(filePath);
+}
+
+FileIds PathStore::insert(const QStringList& filePaths)
+{
+  FileIds result;
+  result.reserve(static_cast<std::size_t>(filePaths.size()));
+
+  std::unique_lock<std::shared_mutex> lock(_mutex);
+  for(const QString& filePath : filePaths) {
+    const FileId id = insertPath(filePath);
+    if( id != kNoParent ) {
+      result.push_back(id);
+    }
+  }
+
+  return result;
+}
+
+QString PathStore::relativeFilePath(const FileId id, const FileId ancestor) const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  if( ancestor >= _nodes.size() ) {
+    return QString();
+  }
+  return QString::fromStdString(filePathUtf8(id, ancestor));
+}
+
+bool PathStore::isLess(const FileId a, const FileId b) const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return isLessUnlocked(a, b);
+}
+
+bool PathStore::isValid(const FileId id) const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return id < _nodes.size();
+}
+
+std::size_t PathStore::size() const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  return _nodes.size();
+}
+
+void PathStore::sort(FileIds& ids) const
+{
+  std::shared_lock<std::shared_mutex> lock(_mutex);
+  std::sort(ids.begin(), ids.end(), [this](const FileId a, const FileId b) -> bool {
+    return isLessUnlocked(a, b);
+  });
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+PathStorePtr PathStore::create()
+{
+  return std::make_shared<PathStore>();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+// NOTE: Returns the path below 'ancestor'; or an empty string, if 'id'
+//       does not descend from 'ancestor'.
+std::string PathStore::filePathUtf8(const FileId id, const FileId ancestor) const
+{
+  if( id >= _nodes.size()  ||  id == ancestor ) {
+    return std::string();
+  }
+
+  // (1) Compute size of path ////////////////////////////////////////////////
+
+  std::size_t size = 0;
+  FileId top = id;
+  for(; top != kNoParent  &&  top != ancestor; top = _nodes[top].parent) {
+    size += _nodes[top].size + 1;
+  }
+  if( top != ancestor ) {
+    return std::string();
+  }
+  size--; // No separator in front of the first component
+
+  if( size == 0 ) {
+    return ancestor == kNoParent  &&  _nodes[id].parent == kNoParent  &&  _nodes[id].size == 0
+        ? std::string(1, '/')
+        : std::string();
+  }
+
+  // (2) Fill path from its back /////////////////////////////////////////////
+
+  std::string result(size, '/');
+  for(FileId i = id; i != ancestor; i = _nodes[i].parent) {
+    const std::string_view s = name(_nodes[i]);
+    size -= s.size();
+    std::copy(s.cbegin(), s.cend(), result.begin() + size);
+    if( size > 0 ) {
+      size--;
+    }
+  }
+
+  return result;
+}
+
+FileId PathStore::insertComponent(const FileId parent, const std::string_view& name)
+{
+  const std::size_t hash = priv::hashComponent(parent, name);
+
+  const std::pair<Index::const_iterator,Index::const_iterator> range = _index.equal_range(hash);
+  for(Index::const_iterator it = range.first; it != range.second; ++it) {
+    const Node& node = _nodes[it->second];
+    if( node.parent == parent  &&  PathStore::name(node) == name ) {
+      return it->second;
+    }
+  }
+
+  const FileId id = static_cast<FileId>(_nodes.size());
+  const uint16_t depth = parent != kNoParent
+      ? uint16_t(_nodes[parent].depth + 1)
+      : uint16_t(0);
+  _nodes.push_back(Node{parent, static_cast<uint32_t>(_names.size()), static_cast<uint16_t>(name.size()), depth});
+  _names.append(name.data(), name.size());
+  _index.emplace(hash, id);
+
+  return id;
+}
+
+// NOTE: Components are separated by '/'; empty components are skipped,
+//       except the leading one representing the root of an absolute path.
+FileId PathStore::insertPath(const QString& filePath)
+{
+  const std::string utf8 = filePath.toStdString();
+  if( utf8.empty()  ||  _nodes.size() >= std::size_t(kNoParent - 1) ) {
+    return kNoParent;
+  }
+
+  const std::string_view path(utf8);
+
+  FileId id = kNoParent;
+  std::size_t pos = 0;
+  while( pos <= path.size() ) {
+    std::size_t end = path.find('/', pos);
+    if( end == std::string_view::npos ) {
+      end = path.size();
+    }
+
+    const std::string_view component = path.substr(pos, end - pos);
+    if( component.size() > kMaxComponent ) {
+      return kNoParent;
+    }
+    if( !component.empty()  ||  pos == 0 ) {
+      id = insertComponent(id, component);
+    }
+
+    pos = end + 1;
+  }
+
+  return id;
+}
+
+bool PathStore::isLessUnlocked(FileId a, FileId b) const
+{
+  if( a == b  ||  a >= _nodes.size()  ||  b >= _nodes.size() ) {
+    return a < b  &&  b >= _nodes.size(); // Invalid IDs last
+  }
+
+  // (1) Ascend to the same depth; an ancestor is less than its descendants //
+
+  while( _nodes[a].depth > _nodes[b].depth ) {
+    a = _nodes[a].parent;
+    if( a == b ) {
+      return false;
+    }
+  }
+  while( _nodes[b].depth > _nodes[a].depth ) {
+    b = _nodes[b].parent;
+    if( a == b ) {
+      return true;
+    }
+  }
+
+  // (2) Ascend to the components below the common ancestor //////////////////
+
+  while( _nodes[a].parent != _nodes[b].parent ) {
+    a = _nodes[a].parent;
+    b = _nodes[b].parent;
+  }
+
+  return name(_nodes[a]) < name(_nodes[b]);
+}
+
+std::string_view PathStore::name(const Node& node) const
+{
+  return std::string_view(_names).substr(node.offset, node.size);
+}
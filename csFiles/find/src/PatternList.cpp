@@ -40,7 +40,7 @@ QString cleanPatternList(const QString& s)
 
 QStringList preparePatternList(QString s)
 {
-  s.remove(QRegExp(QStringLiteral("[^.,0-9a-z]"), Qt::CaseInsensitive));
+  s.remove(QRegExp(QStringLiteral("[^-.,0-9_a-z]"), Qt::CaseInsensitive));
   QStringList result = s.split(QChar::fromLatin1(','), QString::SkipEmptyParts);
   result.removeAll(QStringLiteral("."));
   return result;
@@ -0,0 +1,545 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <unordered_map>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QSaveFile>
+
+#include "DirectoryReader.h"
+
+#include "TreeSnapshot.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr char kMagic[8] = {'c', 's', 'F', 'S', 'N', 'A', 'P', '\0'};
+
+constexpr uint32_t kVersion = 1;
+
+// NOTE: A directory modified this close to the snapshot's creation may have
+//       been modified again within the same timestamp; it is read again.
+constexpr int64_t kRacyInterval = 2000; // [ms]
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t rootSize;
+    uint64_t numDirs;
+    uint64_t numEntries;
+    uint64_t namesSize;
+    int64_t  created; // [ms] since epoch
+  };
+
+  static_assert(sizeof(Header) == 48, "Invalid size of snapshot header!");
+  static_assert(sizeof(TreeSnapshot::Directory) == 32, "Invalid size of snapshot directory!");
+  static_assert(sizeof(TreeSnapshot::Entry) == 32, "Invalid size of snapshot entry!");
+
+  std::string joinPath(const std::string& dirPath, const std::string_view& name)
+  {
+    std::string result(dirPath);
+    if( result.empty()  ||  result.back() != '/' ) {
+      result.push_back('/');
+    }
+    result.append(name.data(), name.size());
+    return result;
+  }
+
+  // NOTE: Returns the modification time of the directory 'path', or -1.
+  int64_t lastModifiedDir(const std::string& path)
+  {
+    const std::string::size_type slash = path.rfind('/');
+    if( slash == std::string::npos ) {
+      return -1;
+    }
+
+    FindEntry entry;
+    entry.setDirectory(std::string_view(path).substr(0, slash > 0 ? slash : 1));
+    entry.setName(std::string_view(path).substr(slash + 1), FindType::Unknown);
+
+    return entry.isDir()
+        ? entry.lastModified()
+        : -1;
+  }
+
+  bool write(QSaveFile& file, const void *data, const std::size_t size)
+  {
+    return size < 1  ||
+        file.write(reinterpret_cast<const char*>(data), qint64(size)) == qint64(size);
+  }
+
+} // namespace priv
+
+////// SnapshotBuilder ///////////////////////////////////////////////////////
+
+// NOTE: Builds a new snapshot from the tree and an (optional) old snapshot;
+//       the records of an unmodified directory are copied from the old
+//       snapshot, including the records of its subdirectories.
+
+class SnapshotBuilder {
+public:
+  SnapshotBuilder(const TreeSnapshot *old, const std::string& rootPath)
+    : _old(old)
+    , _rootPath(rootPath)
+  {
+  }
+
+  TreeSnapshotPtr build(bool *changed)
+  {
+    TreeSnapshotPtr result(new TreeSnapshot());
+    result->_created = QDateTime::currentMSecsSinceEpoch();
+
+    _dirs  = &result->_dirStorage;
+    _ents  = &result->_entryStorage;
+    _names = &result->_nameStorage;
+    _changed = _old == nullptr;
+
+    // (1) Root ////////////////////////////////////////////////////////////////
+
+    _names->assign(_rootPath);
+    _dirs->push_back(TreeSnapshot::Directory{0, uint32_t(_rootPath.size()),
+                                             TreeSnapshot::kNoDirectory, 0, 0, 0, 0});
+
+    _pending.push_back(Pending{TreeSnapshot::kRootDirectory,
+                               _old != nullptr ? TreeSnapshot::kRootDirectory : TreeSnapshot::kNoDirectory,
+                               _rootPath});
+
+    // (2) Walk tree ///////////////////////////////////////////////////////////
+
+    while( !_pending.empty() ) {
+      const Pending p = std::move(_pending.back());
+      _pending.pop_back();
+
+      const int64_t lastModified = priv::lastModifiedDir(p.path);
+      if( p.dir == TreeSnapshot::kRootDirectory  &&  lastModified < 0 ) {
+        return TreeSnapshotPtr();
+      }
+
+      (*_dirs)[p.dir].lastModified = lastModified;
+      (*_dirs)[p.dir].firstEntry = uint32_t(_ents->size());
+
+      if( lastModified < 0 ) {
+        _changed = true;
+      } else if( isUnmodified(p.old, lastModified) ) {
+        copyDirectory(p);
+      } else {
+        readDirectory(p);
+        _changed = true;
+      }
+
+      (*_dirs)[p.dir].numEntries = uint32_t(_ents->size()) - (*_dirs)[p.dir].firstEntry;
+
+      if( _dirs->size() >= TreeSnapshot::kNoDirectory  ||
+          _ents->size() >= TreeSnapshot::kNoDirectory  ||
+          _names->size() >= TreeSnapshot::kNoDirectory ) {
+        return TreeSnapshotPtr();
+      }
+    }
+
+    // (3) Views ///////////////////////////////////////////////////////////////
+
+    result->_dirs       = _dirs->data();
+    result->_numDirs    = _dirs->size();
+    result->_entries    = _ents->data();
+    result->_numEntries = _ents->size();
+    result->_names      = std::string_view(*_names);
+    result->_rootSize   = _rootPath.size();
+
+    if( changed != nullptr ) {
+      *changed = _changed;
+    }
+
+    return result;
+  }
+
+private:
+  struct Pending {
+    uint32_t dir;
+    uint32_t old;
+    std::string path;
+  };
+
+  uint32_t addDirectory(const uint32_t parent, const uint32_t name, const uint32_t nameSize)
+  {
+    const uint32_t index = uint32_t(_dirs->size());
+    _dirs->push_back(TreeSnapshot::Directory{name, nameSize, parent, 0, 0, 0, 0});
+    return index;
+  }
+
+  uint32_t addName(const std::string_view& name)
+  {
+    const uint32_t offset = uint32_t(_names->size());
+    _names->append(name.data(), name.size());
+    return offset;
+  }
+
+  void copyDirectory(const Pending& p)
+  {
+    const TreeSnapshot::Directory& oldDir = _old->directory(p.old);
+    for(uint32_t i = 0; i < oldDir.numEntries; i++) {
+      TreeSnapshot::Entry e = _old->entry(oldDir.firstEntry + i);
+      const std::string_view name = _old->name(e);
+
+      e.name = addName(name);
+      if( e.child != TreeSnapshot::kNoDirectory ) {
+        const uint32_t old = e.child;
+        e.child = addDirectory(p.dir, e.name, e.nameSize);
+        _pending.push_back(Pending{e.child, old, priv::joinPath(p.path, name)});
+      }
+
+      _ents->push_back(e);
+    }
+  }
+
+  bool isUnmodified(const uint32_t old, const int64_t lastModified) const
+  {
+    if( old == TreeSnapshot::kNoDirectory ) {
+      return false;
+    }
+    return _old->directory(old).lastModified == lastModified  &&
+        lastModified + kRacyInterval < _old->_created;
+  }
+
+  void readDirectory(const Pending& p)
+  {
+    // NOTE: Subdirectories are matched by name to keep their old records.
+    std::unordered_map<std::string_view,uint32_t> oldChildren;
+    if( p.old != TreeSnapshot::kNoDirectory ) {
+      const TreeSnapshot::Directory& oldDir = _old->directory(p.old);
+      for(uint32_t i = 0; i < oldDir.numEntries; i++) {
+        const TreeSnapshot::Entry& e = _old->entry(oldDir.firstEntry + i);
+        if( e.child != TreeSnapshot::kNoDirectory ) {
+          oldChildren.emplace(_old->name(e), e.child);
+        }
+      }
+    }
+
+    DirectoryReader reader;
+    FindEntry entry;
+    if( !reader.open(p.path, entry) ) {
+      return;
+    }
+
+    while( reader.next(entry) ) {
+      const std::string_view name = entry.fileNameView();
+      if( name.size() > 0xFFFF ) {
+        continue;
+      }
+
+      const FindMetadata& metadata = entry.metadata(FindMetadata::Mode | FindMetadata::Size |
+                                                    FindMetadata::LastModified);
+      const FindType targetType = entry.hasMetadata()
+          ? entry.type()
+          : FindType::Unknown;
+
+      TreeSnapshot::Entry e;
+      e.name         = addName(name);
+      e.nameSize     = uint16_t(name.size());
+      e.type         = uint8_t(entry.isSymLink() ? FindType::SymLink : targetType);
+      e.targetType   = uint8_t(targetType);
+      e.mode         = metadata.mode;
+      e.child        = TreeSnapshot::kNoDirectory;
+      e.size         = metadata.size;
+      e.lastModified = metadata.lastModified;
+
+      if( !entry.isSymLink()  &&  targetType == FindType::Directory ) {
+        const auto hit = oldChildren.find(name);
+        const uint32_t old = hit != oldChildren.cend()
+            ? hit->second
+            : TreeSnapshot::kNoDirectory;
+        e.child = addDirectory(p.dir, e.name, e.nameSize);
+        _pending.push_back(Pending{e.child, old, priv::joinPath(p.path, name)});
+      }
+
+      _ents->push_back(e);
+    }
+  }
+
+  const TreeSnapshot *_old{nullptr};
+  const std::string& _rootPath;
+  std::vector<TreeSnapshot::Directory> *_dirs{nullptr};
+  std::vector<TreeSnapshot::Entry> *_ents{nullptr};
+  std::string *_names{nullptr};
+  std::vector<Pending> _pending{};
+  bool _changed{false};
+};
+
+////// TreeSnapshot - public /////////////////////////////////////////////////
+
+TreeSnapshot::~TreeSnapshot()
+{
+}
+
+std::size_t TreeSnapshot::directoryCount() const
+{
+  return _numDirs;
+}
+
+const TreeSnapshot::Directory& TreeSnapshot::directory(const uint32_t index) const
+{
+  return _dirs[index];
+}
+
+std::size_t TreeSnapshot::entryCount() const
+{
+  return _numEntries;
+}
+
+const TreeSnapshot::Entry& TreeSnapshot::entry(const uint32_t index) const
+{
+  return _entries[index];
+}
+
+std::string_view TreeSnapshot::name(const Directory& dir) const
+{
+  return _names.substr(dir.name, dir.nameSize);
+}
+
+std::string_view TreeSnapshot::name(const Entry& entry) const
+{
+  return _names.substr(entry.name, entry.nameSize);
+}
+
+std::string_view TreeSnapshot::rootPath() const
+{
+  return _names.substr(0, _rootSize);
+}
+
+TreeSnapshotPtr TreeSnapshot::update(const QString& filename, const std::string& rootPath,
+                                     bool *changed)
+{
+  if( changed != nullptr ) {
+    *changed = false;
+  }
+
+  // (1) Load old snapshot ///////////////////////////////////////////////////
+
+  TreeSnapshotPtr old(new TreeSnapshot());
+  if( !old->load(filename)  ||  old->rootPath() != rootPath ) {
+    old.reset();
+  }
+
+  // (2) Revalidate //////////////////////////////////////////////////////////
+
+  bool dirty = false;
+  TreeSnapshotPtr result = SnapshotBuilder(old.get(), rootPath).build(&dirty);
+  if( !result ) {
+    return TreeSnapshotPtr();
+  }
+
+  if( !dirty ) {
+    return old;
+  }
+
+  // (3) Save new snapshot ///////////////////////////////////////////////////
+
+  // NOTE: The old snapshot must be unmapped prior to replacing its file!
+  old.reset();
+
+  result->save(filename);
+
+  if( changed != nullptr ) {
+    *changed = true;
+  }
+
+  return result;
+}
+
+////// TreeSnapshot - private ////////////////////////////////////////////////
+
+bool TreeSnapshot::load(const QString& filename)
+{
+  // (1) Map file ////////////////////////////////////////////////////////////
+
+  _file.setFileName(filename);
+  if( !_file.open(QIODevice::ReadOnly) ) {
+    return false;
+  }
+
+  const qint64 fileSize = _file.size();
+  if( fileSize < qint64(sizeof(priv::Header)) ) {
+    return false;
+  }
+
+  const uchar *data = _file.map(0, fileSize);
+  if( data == nullptr ) {
+    return false;
+  }
+
+  // (2) Validate header /////////////////////////////////////////////////////
+
+  priv::Header header;
+  std::memcpy(&header, data, sizeof(priv::Header));
+  if( std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0  ||  header.version != kVersion ) {
+    return false;
+  }
+
+  if( header.numDirs < 1  ||  header.numDirs >= kNoDirectory  ||
+      header.numEntries >= kNoDirectory  ||  header.namesSize >= kNoDirectory  ||
+      header.rootSize > header.namesSize ) {
+    return false;
+  }
+
+  const uint64_t expected = sizeof(priv::Header) +
+      header.numDirs*sizeof(Directory) + header.numEntries*sizeof(Entry) + header.namesSize;
+  if( uint64_t(fileSize) != expected ) {
+    return false;
+  }
+
+  // (3) Setup views /////////////////////////////////////////////////////////
+
+  const uchar *tables = data + sizeof(priv::Header);
+
+  _dirs       = reinterpret_cast<const Directory*>(tables);
+  _numDirs    = std::size_t(header.numDirs);
+  _entries    = reinterpret_cast<const Entry*>(tables + _numDirs*sizeof(Directory));
+  _numEntries = std::size_t(header.numEntries);
+  _names      = std::string_view(reinterpret_cast<const char*>(tables + _numDirs*sizeof(Directory) +
+                                                               _numEntries*sizeof(Entry)),
+                                 std::size_t(header.namesSize));
+  _rootSize   = header.rootSize;
+  _created    = header.created;
+
+  // (4) Validate tables; a snapshot's references must never leave its file //
+
+  for(std::size_t i = 0; i < _numDirs; i++) {
+    const Directory& dir = _dirs[i];
+    if( uint64_t(dir.name) + dir.nameSize > _names.size()  ||
+        uint64_t(dir.firstEntry) + dir.numEntries > _numEntries  ||
+        (dir.parent != kNoDirectory  &&  dir.parent >= _numDirs) ) {
+      return false;
+    }
+  }
+
+  for(std::size_t i = 0; i < _numEntries; i++) {
+    const Entry& entry = _entries[i];
+    if( uint64_t(entry.name) + entry.nameSize > _names.size()  ||
+        (entry.child != kNoDirectory  &&  (entry.child == kRootDirectory  ||  entry.child >= _numDirs)) ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool TreeSnapshot::save(const QString& filename) const
+{
+  QSaveFile file(filename);
+  if( !file.open(QIODevice::WriteOnly) ) {
+    return false;
+  }
+
+  priv::Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version    = kVersion;
+  header.rootSize   = uint32_t(_rootSize);
+  header.numDirs    = _numDirs;
+  header.numEntries = _numEntries;
+  header.namesSize  = _names.size();
+  header.created    = _created;
+
+  if( !priv::write(file, &header, sizeof(priv::Header))  ||
+      !priv::write(file, _dirs, _numDirs*sizeof(Directory))  ||
+      !priv::write(file, _entries, _numEntries*sizeof(Entry))  ||
+      !priv::write(file, _names.data(), _names.size()) ) {
+    file.cancelWriting();
+    return false;
+  }
+
+  return file.commit();
+}
+
+////// SnapshotReader - public ///////////////////////////////////////////////
+
+uint32_t SnapshotReader::child() const
+{
+  return _child;
+}
+
+void SnapshotReader::close()
+{
+  _snapshot = nullptr;
+  _pos = _end = 0;
+  _child = TreeSnapshot::kNoDirectory;
+}
+
+bool SnapshotReader::isOpen() const
+{
+  return _snapshot != nullptr;
+}
+
+bool SnapshotReader::next(FindEntry& entry)
+{
+  if( _snapshot == nullptr  ||  _pos >= _end ) {
+    close();
+    return false;
+  }
+
+  const TreeSnapshot::Entry& e = _snapshot->entry(_pos++);
+
+  entry.setName(_snapshot->name(e), FindType(e.type));
+  if( FindType(e.targetType) != FindType::Unknown ) {
+    FindMetadata metadata;
+    metadata.mode         = e.mode;
+    metadata.size         = e.size;
+    metadata.lastModified = e.lastModified;
+    entry.setMetadata(metadata, FindMetadata::Mode | FindMetadata::Size | FindMetadata::LastModified,
+                      FindType(e.targetType));
+  }
+  _child = e.child;
+
+  return true;
+}
+
+bool SnapshotReader::open(const TreeSnapshot *snapshot, const uint32_t dir,
+                          const std::string& dirPath, FindEntry& entry)
+{
+  close();
+
+  if( snapshot == nullptr  ||  dir >= snapshot->directoryCount() ) {
+    return false;
+  }
+
+  const TreeSnapshot::Directory& d = snapshot->directory(dir);
+
+  _snapshot = snapshot;
+  _pos = d.firstEntry;
+  _end = d.firstEntry + d.numEntries;
+
+  entry.setDirectory(dirPath);
+
+  return true;
+}
@@ -0,0 +1,61 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "VisitedDirectories.h"
+
+////// DirectoryIdentity - public ////////////////////////////////////////////
+
+bool operator==(const DirectoryIdentity& a, const DirectoryIdentity& b)
+{
+  return a.device == b.device  &&  a.inode == b.inode;
+}
+
+////// VisitedDirectories - public ///////////////////////////////////////////
+
+bool VisitedDirectories::insert(const DirectoryIdentity& id)
+{
+  const std::size_t hash = Hash()(id);
+  Shard& shard = _shards[(hash >> 7) % kNumShards];
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.set.insert(id).second;
+}
+
+////// VisitedDirectories - private //////////////////////////////////////////
+
+std::size_t VisitedDirectories::Hash::operator()(const DirectoryIdentity& id) const
+{
+  // NOTE: Mixing cf. SplitMix64; inodes of a device are mostly sequential.
+  uint64_t x = id.inode ^ (id.device*UINT64_C(0x9E3779B97F4A7C15));
+  x = (x ^ (x >> 30))*UINT64_C(0xBF58476D1CE4E5B9);
+  x = (x ^ (x >> 27))*UINT64_C(0x94D049BB133111EB);
+  return static_cast<std::size_t>(x ^ (x >> 31));
+}
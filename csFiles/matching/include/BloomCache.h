@@ -0,0 +1,132 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef BLOOMCACHE_H
+#define BLOOMCACHE_H
+
+#include <cstdint>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include "FileStamp.h"
+#include "PatternLiterals.h"
+#include "TextUtil.h"
+
+// NOTE: Collects the trigrams of the lines of a file, while it is matched,
+//       into a Bloom filter sized after the file's size; the filter is folded
+//       to fit the number of trigrams when it is stored.
+
+class BloomBuilder {
+public:
+  BloomBuilder(const qint64 fileSize) noexcept;
+  ~BloomBuilder() noexcept;
+
+  void add(const TextLine& line);
+
+private:
+  BloomBuilder(const BloomBuilder&) = delete;
+  BloomBuilder& operator=(const BloomBuilder&) = delete;
+
+  std::vector<uint64_t> _bits{};
+
+  friend class BloomCache;
+};
+
+using BloomBuilderPtr = std::unique_ptr<BloomBuilder>;
+
+// NOTE: A directory of Bloom filters of the trigrams of files, one per file
+//       (named after the hash of its path). A filter is valid as long as
+//       the file's stamp is unchanged; files whose filter lacks any trigram
+//       of the pattern's literals are not matched at all.
+//       The directory's size is bounded; the least recently used filters
+//       are removed first.
+
+class BloomCache;
+
+using BloomCachePtr = std::unique_ptr<BloomCache>;
+
+class BloomCache {
+public:
+  enum class Status {
+    Unknown = 0, // No (valid) filter; the file needs to be matched
+    Accepted,    // The file may match
+    Rejected     // The file cannot match
+  };
+
+  ~BloomCache();
+
+  // NOTE: Returns a builder, if the filter of a file should be (re-)built
+  //       while it is matched; i.e. 'status' is Unknown and the file was not
+  //       modified too recently.
+  BloomBuilderPtr builder(const FileStamp& stamp, const Status status) const;
+  Status lookup(const QString& filename, const FileStamp& stamp) const;
+  void store(const QString& filename, const FileStamp& stamp, const BloomBuilder& builder);
+
+  static BloomCachePtr create(const QString& path, const PatternLiterals& literals,
+                              const qint64 maxSize = 64*1024*1024);
+
+private:
+  struct Entry {
+    qint64 size{0};
+    qint64 lastUsed{0}; // [ms] since epoch
+  };
+
+  BloomCache() = delete;
+  BloomCache(const QString& path, const PatternLiterals& literals, const qint64 maxSize);
+
+  BloomCache(const BloomCache&) = delete;
+  BloomCache& operator=(const BloomCache&) = delete;
+
+  BloomCache(BloomCache&&) = delete;
+  BloomCache& operator=(BloomCache&&) = delete;
+
+  QString entryPath(const QString& filename) const;
+  void evict();
+  void scan();
+  void touch(const QString& entryName, const qint64 size) const;
+
+  QString _path{};
+  qint64 _maxSize{0};
+  std::vector<uint32_t> _trigrams{}; // Of the literals
+  qint64 _created{0};
+  // Entries by name, if scanned
+  mutable std::mutex _mutex{};
+  mutable QHash<QString,Entry> _entries{};
+  mutable qint64 _totalSize{0};
+  bool _scanned{false};
+};
+
+#endif // BLOOMCACHE_H
@@ -0,0 +1,103 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CORPUSCACHE_H
+#define CORPUSCACHE_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include "FileStamp.h"
+#include "TextInfo.h"
+
+// NOTE: Keeps the contents of the files most recently matched in memory,
+//       together with their TextInfo; binary files are only kept as such.
+//       Contents are valid as long as the stamp of their file is unchanged.
+//       The memory used is bounded by 'maxSize'; the least recently used
+//       files are evicted first. Optionally, contents are compressed.
+
+class CorpusCache {
+public:
+  struct Statistics {
+    uint64_t files{0};
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t size{0}; // [Byte]
+  };
+
+  CorpusCache(const qint64 maxSize = 256*1024*1024, const bool compress = false);
+  ~CorpusCache();
+
+  void clear();
+  // NOTE: Returns true if the contents of a file of 'stamp' would be kept.
+  bool isCacheable(const FileStamp& stamp) const;
+  bool lookup(const QString& filename, const FileStamp& stamp, QByteArray& contents, TextInfo& info);
+  Statistics statistics() const;
+  void store(const QString& filename, const FileStamp& stamp, const QByteArray& contents,
+             const TextInfo& info);
+
+private:
+  struct Entry {
+    QString filename{};
+    FileStamp stamp{};
+    QByteArray data{};
+    TextInfo info{};
+    qint64 size{0}; // Accounted
+  };
+
+  using Entries = std::list<Entry>; // Most recently used first
+
+  CorpusCache(const CorpusCache&) = delete;
+  CorpusCache& operator=(const CorpusCache&) = delete;
+
+  CorpusCache(CorpusCache&&) = delete;
+  CorpusCache& operator=(CorpusCache&&) = delete;
+
+  void remove(const Entries::iterator& it);
+
+  qint64 _maxSize{0};
+  bool _compress{false};
+  mutable std::mutex _mutex{};
+  Entries _entries{};
+  QHash<QString,Entries::iterator> _index{};
+  qint64 _size{0};
+  std::atomic<uint64_t> _hits{0};
+  std::atomic<uint64_t> _misses{0};
+};
+
+#endif // CORPUSCACHE_H
@@ -152,6 +152,14 @@ public:
     return CacheView<value_type>{first(), last()};
   }
 
+  // NOTE: 'pos' is a position in the file!
+  inline const value_type *at(const size_type pos) const
+  {
+    return _bot <= pos  &&  pos <= _top
+        ? _buffer.data() + (pos - _bot)
+        : nullptr;
+  }
+
   // Cursor //////////////////////////////////////////////////////////////////
 
   inline size_type cursor() const
@@ -179,31 +187,36 @@ public:
     return true;
   }
 
-  void shift()
+  // NOTE: Keeps up to 'keep' bytes in front of the cursor; returns the
+  //       number of bytes the cached data was moved towards the front.
+  size_type shift(const size_type keep = 0)
   {
     // (1) Check cursor's alignment //////////////////////////////////////////
 
-    if( _cur == 0 ) {
-      return;
+    const size_type offset = _cur - std::min<size_type>(keep, _cur);
+    if( offset == 0 ) {
+      return 0;
     }
 
-    // (2) Get cursor's view of the cache ////////////////////////////////////
+    // (2) Get the view of the retained cache ////////////////////////////////
 
-    const CacheView<value_type> cv = view(); // We will move the markers below!
+    const CacheView<value_type> cv{_buffer.data() + offset, last()}; // We will move the markers below!
 
     // (3) Advance cache's view of the file //////////////////////////////////
 
-    _bot += _cur;
+    _bot += offset;
 
     // (4) Align cursor //////////////////////////////////////////////////////
 
-    _cur = 0;
+    _cur -= offset;
 
     // (5) Move cached data //////////////////////////////////////////////////
 
     if( diff(cv) > 0 ) {
       std::copy(cv.first, cv.second, _buffer.data());
     }
+
+    return offset;
   }
 
   // File Information ////////////////////////////////////////////////////////
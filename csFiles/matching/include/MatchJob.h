@@ -0,0 +1,137 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef MATCHJOB_H
+#define MATCHJOB_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include "IMatcher.h"
+#include "PathStore.h"
+
+class BloomCache;
+class CorpusCache;
+class MatchLog;
+class ResultCache;
+
+////// MatchJob //////////////////////////////////////////////////////////////
+
+struct MatchJob {
+  MatchJob() noexcept = default;
+  MatchJob(const MatchJob& other) noexcept;
+  MatchJob(const PathStore *_paths, const FileId _fileId) noexcept;
+
+  MatchJob(MatchJob&&) noexcept = default;
+  MatchJob& operator=(MatchJob&&) noexcept = default;
+
+  QString filename() const;
+
+  const PathStore *paths{nullptr};
+  FileId fileId{0};
+  MatchLog *log{nullptr};
+  BloomCache *bloom{nullptr}; // Optional
+  CorpusCache *corpus{nullptr}; // Optional
+  ResultCache *results{nullptr}; // Optional
+  IMatcherPtr matcher{};
+  int contextAfter{0};
+  int contextBefore{0};
+};
+
+using MatchJobs = std::vector<MatchJob>;
+
+////// MatchedLine ///////////////////////////////////////////////////////////
+
+// NOTE: A MatchedLine only indexes into the storage of its MatchResult;
+//       the extent of line 'i' ends where line 'i + 1' begins.
+//       A line without any matches is a context line.
+struct MatchedLine {
+  MatchedLine() noexcept = default;
+  MatchedLine(const std::size_t _text, const std::size_t _match, const int _number) noexcept;
+
+  std::size_t text{};
+  std::size_t match{};
+  int         number{};
+};
+
+bool operator<(const MatchedLine& a, const MatchedLine& b);
+
+using MatchedLines = std::vector<MatchedLine>;
+
+using MatchView = CacheView<Match>;
+
+////// MatchResult ///////////////////////////////////////////////////////////
+
+struct MatchResult {
+  MatchResult() noexcept = default;
+  MatchResult(const MatchJob& job) noexcept;
+
+  MatchResult(const MatchResult&) = delete;
+  MatchResult& operator=(const MatchResult&) = delete;
+
+  MatchResult(MatchResult&&) noexcept = default;
+  MatchResult& operator=(MatchResult&&) noexcept = default;
+
+  bool append(const TextLine& line, const int lineno, const MatchList& list);
+  bool appendContext(const TextLine& line, const int lineno);
+
+  QString filename() const;
+  bool isEmpty() const;
+
+  int lineCount() const;
+  bool lineIsContext(const int i) const;
+  MatchView lineMatches(const int i) const;
+  int lineNumber(const int i) const;
+  QString lineText(const int i) const;
+  TextLine lineView(const int i) const;
+
+  const PathStore   *paths{nullptr};
+  FileId             fileId{0};
+  MatchedLines       lines{};
+  std::vector<Match> matches{};
+  std::string        text{}; // UTF-8
+};
+
+// NOTE: Results are built once by the worker and shared read-only afterwards!
+using MatchResultPtr = std::shared_ptr<const MatchResult>;
+
+using MatchResults = QList<MatchResultPtr>;
+
+////// Functions /////////////////////////////////////////////////////////////
+
+// NOTE: Returns an empty pointer if nothing matched.
+MatchResultPtr executeJob(const MatchJob& job);
+
+#endif // MATCHJOB_H
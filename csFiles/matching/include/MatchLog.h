@@ -0,0 +1,102 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef MATCHLOG_H
+#define MATCHLOG_H
+
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string>
+
+class MatchLog {
+public:
+  enum class Level {
+    Warning = 0,
+    Error
+  };
+
+  using Sink = std::function<void(const Level, const std::string&)>;
+
+  struct Statistics {
+    uint64_t bytes{0};
+    uint64_t errors{0};
+    uint64_t files{0};
+    uint64_t reused{0}; // Results of unchanged files
+    uint64_t suppressed{0};
+    uint64_t warnings{0};
+  };
+
+  MatchLog(const Sink& sink = Sink(), const int maxMessagesPerSecond = 50);
+  ~MatchLog();
+
+  void addFile(const uint64_t bytes);
+  void addReused();
+  void forward(const Level level, const std::string& message) const;
+  bool record(const Level level);
+  Statistics statistics() const;
+
+private:
+  MatchLog(const MatchLog&) = delete;
+  MatchLog& operator=(const MatchLog&) = delete;
+
+  MatchLog(MatchLog&&) = delete;
+  MatchLog& operator=(MatchLog&&) = delete;
+
+  static constexpr std::size_t kNumSlots = 32;
+
+  // NOTE: Every thread counts into a slot of its own (on a cache line of
+  //       its own), which are only summed up by statistics(); all counters
+  //       are updated lock-free and without any ordering!
+  struct alignas(64) Counters {
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> files{0};
+    std::atomic<uint64_t> reused{0};
+    std::atomic<uint64_t> suppressed{0};
+    std::atomic<uint64_t> warnings{0};
+  };
+
+  bool acquireMessage();
+  Counters& counters();
+
+  std::array<Counters,kNumSlots> _counters{};
+  // Rate Limit
+  int _maxMessages{0};
+  std::atomic<int> _numMessages{0};
+  std::atomic<int64_t> _windowStart{0};
+  // Forwarding
+  Sink _sink{};
+};
+
+#endif // MATCHLOG_H
@@ -0,0 +1,90 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include "FileStamp.h"
+#include "MatchJob.h"
+
+// NOTE: Keeps the results of the most recent searches by file; a result,
+//       including the lack of any match, is reused as long as the stamp of
+//       its file is unchanged. A search is identified by the pattern, the
+//       flags and the context of its jobs.
+//       Results of files modified just before they were matched are not
+//       kept, as they may be modified again within the same timestamp.
+
+class ResultCache {
+public:
+  ResultCache(const int maxSearches = 2);
+  ~ResultCache();
+
+  void clear();
+
+  // NOTE: Returns true if a result of 'job' is cached for 'stamp';
+  //       'result' is empty if the file did not match.
+  bool lookup(const MatchJob& job, const QString& filename, const FileStamp& stamp,
+              MatchResultPtr& result);
+  void store(const MatchJob& job, const QString& filename, const FileStamp& stamp,
+             const MatchResultPtr& result);
+
+private:
+  struct Entry {
+    FileStamp stamp{};
+    MatchResultPtr result{};
+  };
+
+  struct Search {
+    std::string key{};
+    QHash<QString,Entry> entries{};
+  };
+
+  ResultCache(const ResultCache&) = delete;
+  ResultCache& operator=(const ResultCache&) = delete;
+
+  ResultCache(ResultCache&&) = delete;
+  ResultCache& operator=(ResultCache&&) = delete;
+
+  Search *findSearch(const std::string& key, const bool create);
+
+  std::mutex _mutex{};
+  std::list<Search> _searches{}; // Most recently used first
+  int _maxSearches{0};
+};
+
+#endif // RESULTCACHE_H
@@ -35,6 +35,7 @@
 #include <cstddef>
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "TextInfo.h"
@@ -58,6 +59,13 @@ public:
   bool hasNextLine() const;
   TextLine nextLine(const bool keepEnding = true, bool *ok = nullptr);
 
+  // NOTE: The history holds views of the lines preceding the line
+  //       most recently returned by nextLine(); oldest line first.
+  size_type historyCount() const;
+  TextLine historyLine(const size_type i) const;
+  size_type historySize() const;
+  void setHistorySize(const size_type size);
+
   // NOTE: TextBuffer takes ownership of 'device'!
   static TextBufferPtr create(QIODevice *device);
 
@@ -69,17 +77,26 @@ private:
 
   TextBuffer(QIODevice *device) noexcept;
 
+  using HistoryLine = std::pair<size_type,size_type>; // File positions
+
   bool canFill() const;
   bool canGrow() const;
+  void clearHistory();
   bool cursorAtEof() const;
   bool eofCached() const;
   bool fillCache();
   const char *findNextLine() const;
   bool growCache();
+  size_type historyBytes() const;
+  void pushHistory(const TextLine& line);
 
   TextFileCache _cache{};
   QIODevice    *_device{nullptr};
   TextInfo      _info{};
+  // History Ring
+  std::vector<HistoryLine> _history{};
+  size_type _historyHead{0};
+  size_type _historyUsed{0};
 };
 
 #endif // TEXTBUFFER_H
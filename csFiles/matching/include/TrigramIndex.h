@@ -0,0 +1,159 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <cstdint>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <QtCore/QFile>
+
+#include "IFindFilter.h"
+#include "PatternLiterals.h"
+
+// NOTE: A trigram index lists for every trigram (i.e. three consecutive
+//       bytes of a line) the files containing it; the files below the
+//       root, which may contain all trigrams of a pattern's literals,
+//       are the candidates to be matched.
+//       The index is stored in one file, which is mapped into memory when
+//       loaded; postings are delta encoded as variable length integers.
+//       Trigrams are case folded (ASCII only). Files too large or not
+//       readable are not indexed and hence always candidates.
+//       An index is updated by comparing the sizes and modification
+//       times of the files; only new and modified files are read again.
+
+class TrigramIndex;
+
+using TrigramIndexPtr = std::shared_ptr<const TrigramIndex>;
+
+class TrigramIndex {
+public:
+  ~TrigramIndex();
+
+  // NOTE: Sets 'result' to the candidates of 'literals' by index of file;
+  //       returns false if the literals do not constrain the candidates.
+  bool candidates(const PatternLiterals& literals, std::vector<bool>& result) const;
+  std::size_t fileCount() const;
+  // NOTE: Returns the index of 'filePath', or -1 if it is not indexed.
+  int64_t findFile(const std::string_view& filePath) const;
+  std::string_view rootPath() const;
+  std::size_t trigramCount() const;
+
+  // NOTE: Loads the index of 'rootPath' from 'filename' and brings it up to
+  //       date; the file is (re-)written if anything changed.
+  //       Returns an empty pointer if the root is not a readable directory.
+  static TrigramIndexPtr update(const QString& filename, const std::string& rootPath,
+                                bool *changed = nullptr);
+
+private:
+  struct File {
+    uint32_t path;    // Relative to root
+    uint32_t pathSize;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t size;
+    int64_t  lastModified; // [ms] since epoch
+  };
+
+  struct Trigram {
+    uint32_t trigram;
+    uint32_t count;
+    uint64_t offset;  // Into postings
+  };
+
+  enum FileFlag : uint32_t {
+    Unindexed = 0x01
+  };
+
+  TrigramIndex() = default;
+
+  TrigramIndex(const TrigramIndex&) = delete;
+  TrigramIndex& operator=(const TrigramIndex&) = delete;
+
+  TrigramIndex(TrigramIndex&&) = delete;
+  TrigramIndex& operator=(TrigramIndex&&) = delete;
+
+  std::vector<uint32_t> decode(const Trigram& trigram) const;
+  const Trigram *findTrigram(const uint32_t trigram) const;
+  bool load(const QString& filename);
+  std::string_view path(const File& file) const;
+  bool save(const QString& filename) const;
+
+  // Mapped file, if loaded
+  QFile _file;
+  // Tables, if built
+  std::vector<File> _fileStorage;
+  std::vector<Trigram> _trigramStorage;
+  std::string _pathStorage;
+  std::string _postingStorage;
+  // Views of the tables
+  const File *_files{nullptr};
+  std::size_t _numFiles{0};
+  const Trigram *_trigrams{nullptr};
+  std::size_t _numTrigrams{0};
+  std::string_view _paths{};
+  std::string_view _postings{};
+  std::size_t _rootSize{0};
+  int64_t _created{0};
+
+  friend class TrigramIndexBuilder;
+};
+
+// NOTE: Rejects files which cannot match a pattern according to an index;
+//       files unknown to the index are accepted.
+
+class TrigramFilter : public IFindFilter {
+public:
+  ~TrigramFilter();
+
+  IFindFilterPtr clone() const;
+  const char *name() const;
+
+  static IFindFilterPtr create(const TrigramIndexPtr& index, const PatternLiterals& literals);
+
+protected:
+  bool isActive() const;
+  bool isMatch(const FindEntry& entry) const;
+
+private:
+  TrigramFilter() = delete;
+  TrigramFilter(const TrigramIndexPtr& index);
+
+  TrigramIndexPtr _index{};
+  std::shared_ptr<const std::vector<bool>> _candidates{};
+};
+
+#endif // TRIGRAMINDEX_H
@@ -0,0 +1,72 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef TRIGRAMS_H
+#define TRIGRAMS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// NOTE: A trigram are three consecutive bytes of a line; it is case folded
+//       (ASCII only) and packed into the lower 24 bits of an integer.
+
+constexpr std::size_t kNumTrigrams = std::size_t(1) << 24;
+
+inline uint32_t foldTrigramCase(const unsigned char c)
+{
+  return 'A' <= c  &&  c <= 'Z'
+      ? uint32_t(c - 'A' + 'a')
+      : uint32_t(c);
+}
+
+inline bool isTrigramBreak(const unsigned char c)
+{
+  return c == '\n'  ||  c == '\r';
+}
+
+// NOTE: Calls 'func' for every trigram of [first,last) not spanning a line break.
+template<typename FuncT>
+void forEachTrigram(const char *first, const char *last, FuncT func)
+{
+  if( last - first < 3 ) {
+    return;
+  }
+  const unsigned char *data = reinterpret_cast<const unsigned char*>(first);
+  const std::size_t size = std::size_t(last - first);
+  for(std::size_t i = 0; i + 2 < size; i++) {
+    if( isTrigramBreak(data[i])  ||  isTrigramBreak(data[i + 1])  ||  isTrigramBreak(data[i + 2]) ) {
+      continue;
+    }
+    func((foldTrigramCase(data[i]) << 16) | (foldTrigramCase(data[i + 1]) << 8) | foldTrigramCase(data[i + 2]));
+  }
+}
+
+#endif // TRIGRAMS_H
@@ -0,0 +1,418 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <bitset>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+
+#ifdef Q_OS_LINUX
+# include <fcntl.h>
+# include <sys/stat.h>
+#endif
+
+#include "Trigrams.h"
+
+#include "BloomCache.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr char kMagic[8] = {'c', 's', 'F', 'B', 'L', 'O', 'M', '\0'};
+
+constexpr uint32_t kVersion = 1;
+
+constexpr uint32_t kMinBits = 1024;
+constexpr uint32_t kMaxBits = 2*1024*1024;
+
+constexpr uint32_t kBitsPerTrigram = 12;
+constexpr uint32_t kNumHashes      =  4;
+
+// NOTE: A filter filled beyond this ratio rejects too few files to be stored.
+constexpr double kMaxFill = 0.5;
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t pathSize;
+    int64_t  size;
+    int64_t  lastModified; // [ms] since epoch
+    uint32_t numBits;
+    uint32_t numHashes;
+  };
+
+  static_assert(sizeof(Header) == 40, "Invalid size of Bloom filter header!");
+
+  // NOTE: The indices of the bits of a trigram are derived by double hashing;
+  //       as only their lower bits are used, a filter may be folded in half.
+  template<typename FuncT>
+  inline void forEachBit(const uint32_t trigram, const uint32_t numBits, FuncT func)
+  {
+    uint64_t h = uint64_t(trigram) + 0x9E3779B97F4A7C15;
+    h = (h ^ (h >> 30))*0xBF58476D1CE4E5B9;
+    h = (h ^ (h >> 27))*0x94D049BB133111EB;
+    h =  h ^ (h >> 31);
+
+    const uint32_t h1 = uint32_t(h);
+    const uint32_t h2 = uint32_t(h >> 32) | 1;
+    for(uint32_t i = 0; i < kNumHashes; i++) {
+      func((h1 + i*h2) & (numBits - 1));
+    }
+  }
+
+  uint64_t hashPath(const QByteArray& path)
+  {
+    uint64_t h = 0xCBF29CE484222325; // FNV-1a
+    for(const char c : path) {
+      h ^= uint64_t(static_cast<unsigned char>(c));
+      h *= 0x100000001B3;
+    }
+    return h;
+  }
+
+  bool isPowerOfTwo(const uint32_t x)
+  {
+    return x != 0  &&  (x & (x - 1)) == 0;
+  }
+
+  bool write(QSaveFile& file, const void *data, const std::size_t size)
+  {
+    return size < 1  ||
+        file.write(reinterpret_cast<const char*>(data), qint64(size)) == qint64(size);
+  }
+
+} // namespace priv
+
+////// BloomBuilder - public /////////////////////////////////////////////////
+
+// NOTE: A file contains at most one trigram per byte.
+BloomBuilder::BloomBuilder(const qint64 fileSize) noexcept
+{
+  const double wantBits = double(std::max<qint64>(fileSize, 0))*kBitsPerTrigram;
+
+  uint32_t numBits = kMinBits;
+  while( numBits < kMaxBits  &&  numBits < wantBits ) {
+    numBits *= 2;
+  }
+
+  try {
+    _bits.assign(numBits/64, 0);
+  } catch(...) {
+    _bits.clear();
+  }
+}
+
+BloomBuilder::~BloomBuilder() noexcept
+{
+}
+
+void BloomBuilder::add(const TextLine& line)
+{
+  if( _bits.empty()  ||  !isValid(line) ) {
+    return;
+  }
+  const uint32_t numBits = uint32_t(_bits.size()*64);
+  forEachTrigram(line.first, line.second, [&](const uint32_t t) -> void {
+    priv::forEachBit(t, numBits, [&](const uint32_t bit) -> void {
+      _bits[bit/64] |= uint64_t(1) << (bit%64);
+    });
+  });
+}
+
+////// BloomCache - public ///////////////////////////////////////////////////
+
+BloomCache::~BloomCache()
+{
+}
+
+BloomBuilderPtr BloomCache::builder(const FileStamp& stamp, const Status status) const
+{
+  if( status != Status::Unknown  ||  !stamp.isValid()  ||  stamp.isRacy(_created) ) {
+    return BloomBuilderPtr();
+  }
+  return std::make_unique<BloomBuilder>(stamp.size);
+}
+
+BloomCache::Status BloomCache::lookup(const QString& filename, const FileStamp& stamp) const
+{
+  if( !stamp.isValid() ) {
+    return Status::Unknown;
+  }
+
+  // (1) Open filter /////////////////////////////////////////////////////////
+
+  QFile file(entryPath(filename));
+  if( !file.open(QIODevice::ReadOnly) ) {
+    return Status::Unknown;
+  }
+
+  // (2) Validate header /////////////////////////////////////////////////////
+
+  const QByteArray path = filename.toUtf8();
+
+  priv::Header header;
+  if( file.read(reinterpret_cast<char*>(&header), sizeof(header)) != qint64(sizeof(header)) ) {
+    return Status::Unknown;
+  }
+
+  if( std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0  ||
+      header.version != kVersion  ||  header.numHashes != kNumHashes  ||
+      header.size != stamp.size  ||  header.lastModified != stamp.lastModified  ||
+      header.pathSize != uint32_t(path.size())  ||
+      !priv::isPowerOfTwo(header.numBits)  ||
+      header.numBits < kMinBits  ||  header.numBits > kMaxBits ) {
+    return Status::Unknown;
+  }
+
+  // NOTE: Different paths may share the same hash!
+  if( file.read(int(header.pathSize)) != path ) {
+    return Status::Unknown;
+  }
+
+  touch(QFileInfo(file.fileName()).fileName(), file.size());
+
+  if( _trigrams.empty() ) {
+    return Status::Accepted;
+  }
+
+  // (3) Test trigrams ///////////////////////////////////////////////////////
+
+  std::vector<uint64_t> bits(header.numBits/64, 0);
+  const qint64 numBytes = qint64(bits.size()*sizeof(uint64_t));
+  if( file.read(reinterpret_cast<char*>(bits.data()), numBytes) != numBytes ) {
+    return Status::Unknown;
+  }
+
+  for(const uint32_t t : _trigrams) {
+    bool found = true;
+    priv::forEachBit(t, header.numBits, [&](const uint32_t bit) -> void {
+      found = found  &&  ((bits[bit/64] >> (bit%64)) & 1) != 0;
+    });
+    if( !found ) {
+      return Status::Rejected;
+    }
+  }
+
+  return Status::Accepted;
+}
+
+void BloomCache::store(const QString& filename, const FileStamp& stamp, const BloomBuilder& builder)
+{
+  const uint32_t builderBits = uint32_t(builder._bits.size()*64);
+  if( !stamp.isValid()  ||  !priv::isPowerOfTwo(builderBits)  ||
+      builderBits < kMinBits  ||  builderBits > kMaxBits ) {
+    return;
+  }
+
+  // (1) Estimate number of trigrams /////////////////////////////////////////
+
+  std::size_t numSet = 0;
+  for(const uint64_t word : builder._bits) {
+    numSet += std::bitset<64>(word).count();
+  }
+
+  const double fill = double(numSet)/double(builderBits);
+  if( fill > kMaxFill ) {
+    return;
+  }
+  const double numTrigrams = -double(builderBits)/double(kNumHashes)*std::log(1.0 - fill);
+
+  // (2) Fold filter to fit //////////////////////////////////////////////////
+
+  const double wantBits = std::max<double>(kMinBits, numTrigrams*kBitsPerTrigram);
+
+  std::vector<uint64_t> bits(builder._bits);
+  uint32_t numBits = builderBits;
+  while( numBits/2 >= wantBits ) {
+    numBits /= 2;
+    const std::size_t half = numBits/64;
+    for(std::size_t i = 0; i < half; i++) {
+      bits[i] |= bits[half + i];
+    }
+    bits.resize(half);
+  }
+
+  // (3) Write filter ////////////////////////////////////////////////////////
+
+  const QByteArray path = filename.toUtf8();
+
+  priv::Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version      = kVersion;
+  header.pathSize     = uint32_t(path.size());
+  header.size         = stamp.size;
+  header.lastModified = stamp.lastModified;
+  header.numBits      = numBits;
+  header.numHashes    = kNumHashes;
+
+  if( !QDir().mkpath(_path) ) {
+    return;
+  }
+
+  QSaveFile file(entryPath(filename));
+  if( !file.open(QIODevice::WriteOnly) ) {
+    return;
+  }
+
+  if( !priv::write(file, &header, sizeof(header))  ||
+      !priv::write(file, path.constData(), std::size_t(path.size()))  ||
+      !priv::write(file, bits.data(), bits.size()*sizeof(uint64_t))  ||
+      !file.commit() ) {
+    return;
+  }
+
+  // (4) Account for filter //////////////////////////////////////////////////
+
+  const std::lock_guard<std::mutex> lock(_mutex);
+
+  if( !_scanned ) {
+    scan();
+  }
+
+  const qint64 size = qint64(sizeof(header)) + path.size() + qint64(bits.size()*sizeof(uint64_t));
+
+  Entry& entry = _entries[QFileInfo(file.fileName()).fileName()];
+  _totalSize += size - entry.size;
+  entry.size     = size;
+  entry.lastUsed = QDateTime::currentMSecsSinceEpoch();
+
+  if( _totalSize > _maxSize ) {
+    evict();
+  }
+}
+
+BloomCachePtr BloomCache::create(const QString& path, const PatternLiterals& literals,
+                                 const qint64 maxSize)
+{
+  if( path.isEmpty()  ||  maxSize < 1 ) {
+    return BloomCachePtr();
+  }
+  return BloomCachePtr(new BloomCache(path, literals, maxSize));
+}
+
+////// BloomCache - private //////////////////////////////////////////////////
+
+BloomCache::BloomCache(const QString& path, const PatternLiterals& literals, const qint64 maxSize)
+  : _path{QDir(path).absolutePath()}
+  , _maxSize{maxSize}
+  , _created{QDateTime::currentMSecsSinceEpoch()}
+{
+  for(const std::string& literal : literals) {
+    forEachTrigram(literal.data(), literal.data() + literal.size(), [&](const uint32_t t) -> void {
+      _trigrams.push_back(t);
+    });
+  }
+  std::sort(_trigrams.begin(), _trigrams.end());
+  _trigrams.erase(std::unique(_trigrams.begin(), _trigrams.end()), _trigrams.end());
+}
+
+QString BloomCache::entryPath(const QString& filename) const
+{
+  const uint64_t hash = priv::hashPath(filename.toUtf8());
+  return QStringLiteral("%1/%2.bloom").arg(_path).arg(qulonglong(hash), 16, 16, QLatin1Char('0'));
+}
+
+// NOTE: Removes the least recently used filters until a quarter of the
+//       maximum size is free again; '_mutex' is locked by the caller.
+void BloomCache::evict()
+{
+  using EntryIter = QHash<QString,Entry>::iterator;
+
+  std::vector<EntryIter> order;
+  order.reserve(std::size_t(_entries.size()));
+  for(EntryIter it = _entries.begin(); it != _entries.end(); ++it) {
+    order.push_back(it);
+  }
+  std::sort(order.begin(), order.end(), [](const EntryIter& a, const EntryIter& b) -> bool {
+    return a.value().lastUsed < b.value().lastUsed;
+  });
+
+  const qint64 wantSize = _maxSize/4*3;
+  QStringList removed;
+  for(const EntryIter& it : order) {
+    if( _totalSize <= wantSize ) {
+      break;
+    }
+    if( QFile::remove(QStringLiteral("%1/%2").arg(_path).arg(it.key())) ) {
+      _totalSize -= it.value().size;
+      removed.push_back(it.key());
+    }
+  }
+
+  for(const QString& name : removed) {
+    _entries.remove(name);
+  }
+}
+
+// NOTE: '_mutex' is locked by the caller.
+void BloomCache::scan()
+{
+  const QFileInfoList infos = QDir(_path).entryInfoList(QStringList(QStringLiteral("*.bloom")),
+                                                        QDir::Files | QDir::Hidden);
+  for(const QFileInfo& info : infos) {
+    Entry& entry = _entries[info.fileName()];
+    entry.size     = info.size();
+    entry.lastUsed = info.lastModified().toMSecsSinceEpoch();
+    _totalSize += entry.size;
+  }
+  _scanned = true;
+}
+
+// NOTE: The modification time of a filter records its last use, which
+//       carries the order of eviction over to other processes.
+void BloomCache::touch(const QString& entryName, const qint64 size) const
+{
+#ifdef Q_OS_LINUX
+  const QByteArray entryPath = QFile::encodeName(QStringLiteral("%1/%2").arg(_path).arg(entryName));
+  ::utimensat(AT_FDCWD, entryPath.constData(), nullptr, 0);
+#endif
+
+  const std::lock_guard<std::mutex> lock(_mutex);
+  if( !_scanned ) {
+    return;
+  }
+
+  Entry& entry = _entries[entryName];
+  _totalSize += size - entry.size;
+  entry.size     = size;
+  entry.lastUsed = QDateTime::currentMSecsSinceEpoch();
+}
@@ -0,0 +1,179 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <iterator>
+
+#include <QtCore/QDateTime>
+
+#include "CorpusCache.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr qint64 kEntryOverhead = 128; // [Byte]
+
+// NOTE: A single file must not take more than this fraction of the cache.
+constexpr qint64 kMaxFileFraction = 8;
+
+////// public ////////////////////////////////////////////////////////////////
+
+CorpusCache::CorpusCache(const qint64 maxSize, const bool compress)
+  : _maxSize{maxSize}
+  , _compress{compress}
+{
+}
+
+CorpusCache::~CorpusCache()
+{
+}
+
+void CorpusCache::clear()
+{
+  const std::lock_guard<std::mutex> lock(_mutex);
+  _entries.clear();
+  _index.clear();
+  _size = 0;
+}
+
+bool CorpusCache::isCacheable(const FileStamp& stamp) const
+{
+  return
+      stamp.isValid()  &&
+      stamp.size <= _maxSize/kMaxFileFraction  &&
+      !stamp.isRacy(QDateTime::currentMSecsSinceEpoch());
+}
+
+bool CorpusCache::lookup(const QString& filename, const FileStamp& stamp, QByteArray& contents,
+                         TextInfo& info)
+{
+  contents.clear();
+  info = TextInfo();
+
+  QByteArray data;
+  {
+    const std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto hit = _index.constFind(filename);
+    if( hit == _index.constEnd() ) {
+      _misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    const Entries::iterator it = hit.value();
+    if( it->stamp != stamp ) {
+      remove(it);
+      _misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    _entries.splice(_entries.begin(), _entries, it);
+    data = it->data; // NOTE: Implicitly shared!
+    info = it->info;
+  }
+
+  // NOTE: Decompress outside of the lock.
+  contents = _compress  &&  !data.isEmpty()
+      ? qUncompress(data)
+      : data;
+  if( contents.size() != stamp.size  &&  !info.isBinary() ) {
+    info = TextInfo();
+    contents.clear();
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  _hits.fetch_add(1, std::memory_order_relaxed);
+
+  return true;
+}
+
+CorpusCache::Statistics CorpusCache::statistics() const
+{
+  Statistics result;
+  {
+    const std::lock_guard<std::mutex> lock(_mutex);
+    result.files = uint64_t(_entries.size());
+    result.size  = uint64_t(_size);
+  }
+  result.hits   = _hits.load(std::memory_order_relaxed);
+  result.misses = _misses.load(std::memory_order_relaxed);
+  return result;
+}
+
+void CorpusCache::store(const QString& filename, const FileStamp& stamp, const QByteArray& contents,
+                        const TextInfo& info)
+{
+  if( !isCacheable(stamp)  ||  (!info.isBinary()  &&  contents.size() != stamp.size) ) {
+    return;
+  }
+
+  // (1) Prepare entry; the contents of binary files are not needed /////////
+
+  Entry entry;
+  entry.filename = filename;
+  entry.stamp    = stamp;
+  entry.info     = info;
+  if( !info.isBinary() ) {
+    entry.data = _compress
+        ? qCompress(contents, 1)
+        : contents;
+  }
+  entry.size = entry.data.size() + filename.size()*qint64(sizeof(QChar)) + kEntryOverhead;
+
+  // (2) Replace any previous entry; evict until it fits /////////////////////
+
+  const std::lock_guard<std::mutex> lock(_mutex);
+
+  const auto old = _index.constFind(filename);
+  if( old != _index.constEnd() ) {
+    remove(old.value());
+  }
+
+  while( !_entries.empty()  &&  _size + entry.size > _maxSize ) {
+    remove(std::prev(_entries.end()));
+  }
+  if( _size + entry.size > _maxSize ) {
+    return;
+  }
+
+  _size += entry.size;
+  _entries.push_front(std::move(entry));
+  _index.insert(filename, _entries.begin());
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+// NOTE: '_mutex' is locked by the caller.
+void CorpusCache::remove(const Entries::iterator& it)
+{
+  _size -= it->size;
+  _index.remove(it->filename);
+  _entries.erase(it);
+}
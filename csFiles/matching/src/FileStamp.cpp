@@ -0,0 +1,92 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "FindEntry.h"
+
+#include "FileStamp.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr int64_t kRacyInterval = 2000; // [ms]
+
+////// public ////////////////////////////////////////////////////////////////
+
+bool FileStamp::isRacy(const int64_t time) const
+{
+  return lastModified + kRacyInterval >= time;
+}
+
+bool FileStamp::isValid() const
+{
+  return size >= 0;
+}
+
+FileStamp FileStamp::of(const QString& filename)
+{
+  const std::string filePath = filename.toStdString();
+
+  const std::string::size_type slash = filePath.rfind('/');
+  if( slash == std::string::npos ) {
+    return FileStamp();
+  }
+
+  FindEntry entry;
+  entry.setDirectory(std::string_view(filePath).substr(0, slash > 0 ? slash : 1));
+  entry.setName(std::string_view(filePath).substr(slash + 1), FindType::Unknown);
+
+  const FindMetadata& metadata = entry.metadata(FindMetadata::Type | FindMetadata::Identity |
+                                                FindMetadata::Size | FindMetadata::LastModified);
+  if( !entry.hasMetadata()  ||  !entry.isFile() ) {
+    return FileStamp();
+  }
+
+  FileStamp result;
+  result.device       = metadata.device;
+  result.inode        = metadata.inode;
+  result.size         = int64_t(metadata.size);
+  result.lastModified = metadata.lastModified;
+
+  return result;
+}
+
+bool operator==(const FileStamp& a, const FileStamp& b)
+{
+  return
+      a.device       == b.device        &&
+      a.inode        == b.inode         &&
+      a.size         == b.size          &&
+      a.lastModified == b.lastModified;
+}
+
+bool operator!=(const FileStamp& a, const FileStamp& b)
+{
+  return !(a == b);
+}
@@ -0,0 +1,172 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QThread>
+
+#include "FindGrep.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+// NOTE: Bounds the memory of a traversal outpacing the matching threads.
+constexpr std::size_t kMaxQueued = 4096;
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  class FileQueue {
+  public:
+    FileQueue() = default;
+
+    void close()
+    {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+      }
+      _notEmpty.notify_all();
+      _notFull.notify_all();
+    }
+
+    // NOTE: Blocks while the queue is empty; returns false once closed and drained.
+    bool pop(FileId& id)
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _notEmpty.wait(lock, [this]() -> bool { return !_files.empty()  ||  _closed; });
+      if( _files.empty() ) {
+        return false;
+      }
+      id = _files.front();
+      _files.pop_front();
+      lock.unlock();
+      _notFull.notify_one();
+      return true;
+    }
+
+    // NOTE: Blocks while the queue is full.
+    void push(const FileIds& ids)
+    {
+      for(const FileId id : ids) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this]() -> bool { return _files.size() < kMaxQueued  ||  _closed; });
+        if( _closed ) {
+          return;
+        }
+        _files.push_back(id);
+        lock.unlock();
+        _notEmpty.notify_one();
+      }
+    }
+
+  private:
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::deque<FileId> _files;
+    bool _closed{false};
+  };
+
+  bool isCanceled(const FindJob& find)
+  {
+    return find.cancel != nullptr  &&  find.cancel->load(std::memory_order_relaxed);
+  }
+
+  void matchWorker(const FindJob& find, const MatchJob& templ, FileQueue& queue,
+                   const MatchResultsSink& sink, std::mutex& sinkMutex)
+  {
+    // NOTE: Copying a job clones its matcher.
+    MatchJob job(templ);
+
+    FileId id;
+    while( queue.pop(id) ) {
+      if( isCanceled(find) ) {
+        continue;
+      }
+
+      job.fileId = id;
+      const MatchResultPtr result = executeJob(job);
+      if( !result  ||  result->isEmpty() ) {
+        continue;
+      }
+
+      std::lock_guard<std::mutex> lock(sinkMutex);
+      sink(result);
+    }
+  }
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+void executeFindGrep(const FindJob& find, const MatchJob& job, PathStore *paths,
+                     const MatchResultsSink& sink, FindStatistics *stats)
+{
+  if( paths == nullptr  ||  !job.matcher  ||  !sink ) {
+    return;
+  }
+
+  // (1) Start matching threads //////////////////////////////////////////////
+
+  MatchJob templ(job);
+  templ.paths = paths;
+
+  priv::FileQueue queue;
+  std::mutex sinkMutex;
+
+  const int numThreads = qMax<int>(1, QThread::idealThreadCount());
+
+  std::vector<std::thread> threads;
+  threads.reserve(static_cast<std::size_t>(numThreads));
+  for(int i = 0; i < numThreads; i++) {
+    threads.emplace_back(priv::matchWorker, std::cref(find), std::cref(templ),
+                         std::ref(queue), std::cref(sink), std::ref(sinkMutex));
+  }
+
+  // (2) Traverse tree; found files are queued batch by batch ////////////////
+
+  executeFind(find, [&](const QStringList& batch) -> void {
+    queue.push(paths->insert(batch));
+  }, stats);
+
+  // (3) Drain queue /////////////////////////////////////////////////////////
+
+  queue.close();
+
+  for(std::thread& thread : threads) {
+    thread.join();
+  }
+}
@@ -0,0 +1,400 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QBuffer>
+#include <QtCore/QFile>
+
+#include "BloomCache.h"
+#include "CorpusCache.h"
+#include "IMatcher.h"
+#include "MatchLog.h"
+#include "ResultCache.h"
+#include "TextBuffer.h"
+
+#include "MatchJob.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  // NOTE: Messages are only formatted if they pass the log's rate limit!
+
+  void printWarning(const MatchJob& job, const char *warning)
+  {
+    if( job.log == nullptr  ||  !job.log->record(MatchLog::Level::Warning) ) {
+      return;
+    }
+    const QString s = QStringLiteral("%1: %2").arg(job.filename()).arg(QString::fromUtf8(warning));
+    job.log->forward(MatchLog::Level::Warning, s.toStdString());
+  }
+
+  void printError(const MatchJob& job, const char *error)
+  {
+    if( job.log == nullptr  ||  !job.log->record(MatchLog::Level::Error) ) {
+      return;
+    }
+    const QString s = QStringLiteral("%1: %2").arg(job.filename()).arg(QString::fromUtf8(error));
+    job.log->forward(MatchLog::Level::Error, s.toStdString());
+  }
+
+  void printError(const MatchJob& job, const int lineno, const char *error)
+  {
+    if( job.log == nullptr  ||  !job.log->record(MatchLog::Level::Error) ) {
+      return;
+    }
+    const QString s = QStringLiteral("%1:%2: %3").arg(job.filename()).arg(lineno).arg(QString::fromUtf8(error));
+    job.log->forward(MatchLog::Level::Error, s.toStdString());
+  }
+
+  QIODevice *openBuffer(const QByteArray& contents)
+  {
+    QBuffer *buffer = new QBuffer();
+    buffer->setData(contents);
+    if( !buffer->open(QIODevice::ReadOnly) ) {
+      delete buffer;
+      return nullptr;
+    }
+    return buffer;
+  }
+
+  // NOTE: Returns the file's contents in memory, if they are to be cached.
+  QIODevice *openFile(const QString& filename, const bool cacheable, QByteArray& contents)
+  {
+    QFile *file = new QFile(filename);
+    if( !file->open(QIODevice::ReadOnly) ) {
+      delete file;
+      return nullptr;
+    }
+    if( !cacheable ) {
+      return file;
+    }
+    contents = file->readAll();
+    delete file;
+    return openBuffer(contents);
+  }
+
+} // namespace priv
+
+////// MatchJob - public /////////////////////////////////////////////////////
+
+MatchJob::MatchJob(const MatchJob& other) noexcept
+  : paths{other.paths}
+  , fileId{other.fileId}
+  , log{other.log}
+  , bloom{other.bloom}
+  , corpus{other.corpus}
+  , results{other.results}
+  , contextAfter{other.contextAfter}
+  , contextBefore{other.contextBefore}
+{
+  if( other.matcher ) {
+    matcher = other.matcher->clone();
+  }
+}
+
+MatchJob::MatchJob(const PathStore *_paths, const FileId _fileId) noexcept
+  : paths{_paths}
+  , fileId{_fileId}
+{
+}
+
+QString MatchJob::filename() const
+{
+  return paths != nullptr
+      ? paths->filePath(fileId)
+      : QString();
+}
+
+////// MatchedLine - public //////////////////////////////////////////////////
+
+MatchedLine::MatchedLine(const std::size_t _text, const std::size_t _match, const int _number) noexcept
+  : text{_text}
+  , match{_match}
+  , number{_number}
+{
+}
+
+bool operator<(const MatchedLine& a, const MatchedLine& b)
+{
+  return a.number < b.number;
+}
+
+////// MatchResult - public //////////////////////////////////////////////////
+
+MatchResult::MatchResult(const MatchJob& job) noexcept
+  : paths{job.paths}
+  , fileId{job.fileId}
+{
+}
+
+QString MatchResult::filename() const
+{
+  return paths != nullptr
+      ? paths->filePath(fileId)
+      : QString();
+}
+
+bool MatchResult::append(const TextLine& line, const int lineno, const MatchList& list)
+{
+  if( diff(line) < 1  ||  lineno < 1  ||  list.empty() ) {
+    return false;
+  }
+
+  const MatchedLine entry(text.size(), matches.size(), lineno);
+  try {
+    text.append(line.first, line.second);
+    matches.insert(matches.end(), list.cbegin(), list.cend());
+    lines.push_back(entry);
+  } catch(...) {
+    text.resize(entry.text);
+    matches.resize(entry.match);
+    return false;
+  }
+
+  return true;
+}
+
+bool MatchResult::appendContext(const TextLine& line, const int lineno)
+{
+  if( !isValid(line)  ||  lineno < 1 ) {
+    return false;
+  }
+
+  const MatchedLine entry(text.size(), matches.size(), lineno);
+  try {
+    text.append(line.first, line.second);
+    lines.push_back(entry);
+  } catch(...) {
+    text.resize(entry.text);
+    return false;
+  }
+
+  return true;
+}
+
+bool MatchResult::isEmpty() const
+{
+  return lines.empty();
+}
+
+int MatchResult::lineCount() const
+{
+  return static_cast<int>(lines.size());
+}
+
+bool MatchResult::lineIsContext(const int i) const
+{
+  return diff(lineMatches(i)) < 1;
+}
+
+MatchView MatchResult::lineMatches(const int i) const
+{
+  if( i < 0  ||  i >= lineCount() ) {
+    return MatchView();
+  }
+  const std::size_t first = lines[i].match;
+  const std::size_t  last = i + 1 < lineCount()
+      ? lines[i + 1].match
+      : matches.size();
+  return MatchView{matches.data() + first, matches.data() + last};
+}
+
+int MatchResult::lineNumber(const int i) const
+{
+  if( i < 0  ||  i >= lineCount() ) {
+    return 0;
+  }
+  return lines[i].number;
+}
+
+QString MatchResult::lineText(const int i) const
+{
+  const TextLine view = lineView(i);
+  return QString::fromUtf8(view.first, static_cast<int>(diff(view)));
+}
+
+TextLine MatchResult::lineView(const int i) const
+{
+  if( i < 0  ||  i >= lineCount() ) {
+    return TextLine();
+  }
+  const std::size_t first = lines[i].text;
+  const std::size_t  last = i + 1 < lineCount()
+      ? lines[i + 1].text
+      : text.size();
+  return TextLine{text.data() + first, text.data() + last};
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+MatchResultPtr executeJob(const MatchJob& job)
+{
+  std::shared_ptr<MatchResult> result;
+
+  if( !job.matcher ) {
+    priv::printError(job, "No matcher set!");
+    return MatchResultPtr();
+  }
+
+  const QString filename = job.filename();
+
+  const FileStamp stamp = job.bloom != nullptr  ||  job.corpus != nullptr  ||  job.results != nullptr
+      ? FileStamp::of(filename)
+      : FileStamp();
+
+  // NOTE: The result of an unchanged file is reused (cf. ResultCache::lookup())!
+  MatchResultPtr reused;
+  if( job.results != nullptr  &&  job.results->lookup(job, filename, stamp, reused) ) {
+    if( job.log != nullptr ) {
+      job.log->addReused();
+    }
+    return reused;
+  }
+
+  // NOTE: A file, which cannot match according to its cached filter, is not read at all!
+  const BloomCache::Status status = job.bloom != nullptr
+      ? job.bloom->lookup(filename, stamp)
+      : BloomCache::Status::Unknown;
+  if( status == BloomCache::Status::Rejected ) {
+    if( job.results != nullptr ) {
+      job.results->store(job, filename, stamp, MatchResultPtr());
+    }
+    return MatchResultPtr();
+  }
+
+  // NOTE: The contents of a file recently matched are read from memory!
+  QByteArray contents;
+  TextInfo info;
+  const bool cached = job.corpus != nullptr  &&  job.corpus->lookup(filename, stamp, contents, info);
+  if( cached  &&  info.isBinary() ) {
+    priv::printWarning(job, "Ignoring binary file!");
+    return MatchResultPtr();
+  }
+  const bool cacheable = !cached  &&  job.corpus != nullptr  &&  job.corpus->isCacheable(stamp);
+
+  QIODevice *file = cached
+      ? priv::openBuffer(contents)
+      : priv::openFile(filename, cacheable, contents);
+  if( file == nullptr ) {
+    priv::printError(job, "Unable to open file!");
+    return MatchResultPtr();
+  }
+
+  if( job.log != nullptr ) {
+    job.log->addFile(static_cast<uint64_t>(file->size()));
+  }
+
+  TextBufferPtr buffer = TextBuffer::create(file);
+  if( !buffer ) {
+    priv::printError(job, "Creation of TextBuffer failed!");
+    return MatchResultPtr();
+  }
+
+  if( cacheable ) {
+    job.corpus->store(filename, stamp, contents, buffer->info());
+  }
+
+  if( buffer->info().isBinary() ) {
+    priv::printWarning(job, "Ignoring binary file!");
+    return MatchResultPtr();
+  }
+
+  if( buffer->info().eolType() == EndOfLine::Unknown ) {
+    priv::printWarning(job, "Ignoring file with indeterminable EOL type!");
+    return MatchResultPtr();
+  }
+
+  if( !job.matcher->setEndOfLine(buffer->info().eolType()) ) {
+    priv::printError(job, "Unable to set EOL type!");
+    return MatchResultPtr();
+  }
+
+  buffer->setHistorySize(static_cast<TextBuffer::size_type>(qMax<int>(0, job.contextBefore)));
+
+  BloomBuilderPtr builder = job.bloom != nullptr
+      ? job.bloom->builder(stamp, status)
+      : BloomBuilderPtr();
+
+  int    lineno = 0;
+  int    lastno = 0; // Number of the last line stored in the result
+  int num_after = 0;
+  while( buffer->hasNextLine() ) {
+    lineno++;
+
+    bool ok = false;
+    const TextLine text = buffer->nextLine(true, &ok);
+    if( !ok  ||  !isValid(text) ) {
+      priv::printError(job, lineno, "Unable to extract line!");
+      return result;
+    }
+
+    if( builder ) {
+      builder->add(text);
+    }
+
+    if( !job.matcher->match(text.first, text.second) ) {
+      if( num_after > 0 ) {
+        result->appendContext(buffer->info().removeEnding(text), lineno);
+        lastno = lineno;
+        num_after--;
+      }
+      continue;
+    }
+
+    if( !result ) {
+      result = std::make_shared<MatchResult>(job);
+    }
+
+    const int num_before = static_cast<int>(buffer->historyCount());
+    for(int i = 0; i < num_before; i++) {
+      const int beforeno = lineno - num_before + i;
+      if( beforeno <= lastno ) {
+        continue;
+      }
+      const TextLine before = buffer->historyLine(static_cast<TextBuffer::size_type>(i));
+      result->appendContext(buffer->info().removeEnding(before), beforeno);
+    }
+
+    result->append(buffer->info().removeEnding(text), lineno, job.matcher->getMatch());
+    lastno = lineno;
+    num_after = job.contextAfter;
+  }
+
+  if( builder ) {
+    job.bloom->store(filename, stamp, *builder);
+  }
+
+  if( job.results != nullptr ) {
+    job.results->store(job, filename, stamp, result);
+  }
+
+  return result;
+}
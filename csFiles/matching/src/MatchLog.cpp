@@ -0,0 +1,149 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <chrono>
+
+#include "MatchLog.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr int64_t kWindowLength = 1000; // [ms]
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  inline int64_t now()
+  {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  // NOTE: Threads are assigned slots round-robin on their first use.
+  std::size_t threadSlot()
+  {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+MatchLog::MatchLog(const Sink& sink, const int maxMessagesPerSecond)
+  : _maxMessages{maxMessagesPerSecond}
+  , _sink{sink}
+{
+  _windowStart = priv::now();
+}
+
+MatchLog::~MatchLog()
+{
+}
+
+void MatchLog::addFile(const uint64_t bytes)
+{
+  Counters& c = counters();
+  c.files.fetch_add(1, std::memory_order_relaxed);
+  c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void MatchLog::addReused()
+{
+  counters().reused.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MatchLog::forward(const Level level, const std::string& message) const
+{
+  if( _sink ) {
+    _sink(level, message);
+  }
+}
+
+bool MatchLog::record(const Level level)
+{
+  Counters& c = counters();
+  if( level == Level::Error ) {
+    c.errors.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    c.warnings.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // NOTE: Without a sink, nothing is suppressed; it is not wanted at all!
+  if( !_sink ) {
+    return false;
+  }
+
+  if( !acquireMessage() ) {
+    c.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  return true;
+}
+
+MatchLog::Statistics MatchLog::statistics() const
+{
+  Statistics result;
+  for(const Counters& c : _counters) {
+    result.bytes      += c.bytes.load(std::memory_order_relaxed);
+    result.errors     += c.errors.load(std::memory_order_relaxed);
+    result.files      += c.files.load(std::memory_order_relaxed);
+    result.reused     += c.reused.load(std::memory_order_relaxed);
+    result.suppressed += c.suppressed.load(std::memory_order_relaxed);
+    result.warnings   += c.warnings.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool MatchLog::acquireMessage()
+{
+  if( _maxMessages < 1 ) {
+    return true;
+  }
+
+  const int64_t    now = priv::now();
+  int64_t        start = _windowStart.load(std::memory_order_relaxed);
+  if( now - start >= kWindowLength  &&
+      _windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed) ) {
+    _numMessages.store(0, std::memory_order_relaxed);
+  }
+
+  return _numMessages.fetch_add(1, std::memory_order_relaxed) < _maxMessages;
+}
+
+MatchLog::Counters& MatchLog::counters()
+{
+  return _counters[priv::threadSlot() % kNumSlots];
+}
@@ -0,0 +1,323 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "PatternLiterals.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  inline bool isAsciiAlnum(const char c)
+  {
+    return ('0' <= c  &&  c <= '9')  ||  ('A' <= c  &&  c <= 'Z')  ||  ('a' <= c  &&  c <= 'z');
+  }
+
+  inline char toLowerAscii(const char c)
+  {
+    return 'A' <= c  &&  c <= 'Z'
+        ? char(c - 'A' + 'a')
+        : c;
+  }
+
+  class LiteralCollector {
+  public:
+    LiteralCollector(const bool caseInsensitive, const bool unicode)
+      : _caseInsensitive{caseInsensitive}
+      , _unicode{unicode}
+    {
+    }
+
+    void append(const char c)
+    {
+      if( _caseInsensitive  &&  (static_cast<unsigned char>(c) & 0x80) != 0 ) {
+        flush();
+        return;
+      }
+      // NOTE: Unicode case folding also matches 'k' with KELVIN SIGN (U+212A)
+      //       and 's' with LATIN SMALL LETTER LONG S (U+017F)!
+      if( _caseInsensitive  &&  _unicode  &&  (toLowerAscii(c) == 'k'  ||  toLowerAscii(c) == 's') ) {
+        flush();
+        return;
+      }
+      _current.push_back(_caseInsensitive ? toLowerAscii(c) : c);
+    }
+
+    void flush()
+    {
+      if( !_current.empty() ) {
+        _literals.push_back(_current);
+      }
+      _current.clear();
+    }
+
+    // NOTE: The last character may occur zero times.
+    void optional()
+    {
+      _current.resize(_current.size() - lastCharSize());
+      flush();
+    }
+
+    // NOTE: The last character may occur many times; it ends one literal
+    //       and begins the next.
+    void repeated()
+    {
+      if( _current.empty() ) {
+        return;
+      }
+      const std::string last = _current.substr(_current.size() - lastCharSize());
+      flush();
+      _current = last;
+    }
+
+    PatternLiterals take()
+    {
+      flush();
+      return std::move(_literals);
+    }
+
+  private:
+    // NOTE: In UTF-8 mode, a quantifier applies to the whole code point,
+    //       i.e. its continuation bytes and its lead byte.
+    std::size_t lastCharSize() const
+    {
+      if( _current.empty() ) {
+        return 0;
+      }
+      if( !_unicode ) {
+        return 1;
+      }
+      std::size_t size = 0;
+      while( size < _current.size()  &&
+             (static_cast<unsigned char>(_current[_current.size() - size - 1]) & 0xC0) == 0x80 ) {
+        size++;
+      }
+      return size < _current.size()
+          ? size + 1
+          : size;
+    }
+
+    bool _caseInsensitive{false};
+    bool _unicode{false};
+    std::string _current{};
+    PatternLiterals _literals{};
+  };
+
+  // NOTE: Returns the position following the class starting at 'pos'.
+  std::size_t skipClass(const std::string& pattern, std::size_t pos)
+  {
+    pos++; // '['
+    if( pos < pattern.size()  &&  pattern[pos] == '^' ) {
+      pos++;
+    }
+    if( pos < pattern.size()  &&  pattern[pos] == ']' ) {
+      pos++;
+    }
+    while( pos < pattern.size()  &&  pattern[pos] != ']' ) {
+      if(        pattern[pos] == '\\' ) {
+        pos++;
+      } else if( pattern.compare(pos, 2, "[:") == 0 ) {
+        const std::size_t end = pattern.find(":]", pos + 2);
+        if( end != std::string::npos ) {
+          pos = end + 1;
+        }
+      }
+      pos++;
+    }
+    return pos + 1;
+  }
+
+  // NOTE: Returns the position following the group starting at 'pos'.
+  std::size_t skipGroup(const std::string& pattern, std::size_t pos)
+  {
+    int depth = 0;
+    while( pos < pattern.size() ) {
+      const char c = pattern[pos];
+      if(        c == '\\' ) {
+        pos += 2;
+        continue;
+      } else if( c == '[' ) {
+        pos = skipClass(pattern, pos);
+        continue;
+      } else if( c == '(' ) {
+        depth++;
+      } else if( c == ')' ) {
+        depth--;
+        if( depth == 0 ) {
+          return pos + 1;
+        }
+      }
+      pos++;
+    }
+    return pos;
+  }
+
+  PatternLiterals regExpLiterals(const std::string& pattern, const bool caseInsensitive,
+                                 const bool unicode)
+  {
+    LiteralCollector collector(caseInsensitive, unicode);
+
+    bool after_quantifier = false;
+    for(std::size_t pos = 0; pos < pattern.size(); ) {
+      const char c = pattern[pos];
+
+      // (1) Quantifiers /////////////////////////////////////////////////////
+
+      if( c == '?'  ||  c == '*'  ||  c == '+'  ||  c == '{' ) {
+        if( after_quantifier  &&  (c == '?'  ||  c == '+') ) {
+          pos++; // Lazy or possessive
+          after_quantifier = false;
+          continue;
+        }
+
+        if( c == '+' ) {
+          collector.repeated();
+        } else {
+          collector.optional();
+        }
+
+        if( c == '{' ) {
+          const std::size_t end = pattern.find('}', pos);
+          pos = end != std::string::npos ? end + 1 : pattern.size();
+        } else {
+          pos++;
+        }
+        after_quantifier = true;
+        continue;
+      }
+      after_quantifier = false;
+
+      // (2) Alternatives, groups & classes //////////////////////////////////
+
+      if( c == '|' ) {
+        return PatternLiterals();
+      }
+
+      if( c == '(' ) {
+        // NOTE: Options, e.g. '(?i)', may change the meaning of everything following!
+        if( pattern.compare(pos, 2, "(?") == 0  &&  pos + 2 < pattern.size() ) {
+          const char kind = pattern[pos + 2];
+          if( kind != ':'  &&  kind != '='  &&  kind != '!'  &&  kind != '<'  &&  kind != '>' ) {
+            return PatternLiterals();
+          }
+        }
+        collector.flush();
+        pos = skipGroup(pattern, pos);
+        // NOTE: A group's quantifier must not apply to the preceding literal!
+        after_quantifier = pos < pattern.size()  &&
+            (pattern[pos] == '?'  ||  pattern[pos] == '*'  ||  pattern[pos] == '+'  ||  pattern[pos] == '{');
+        if( after_quantifier ) {
+          const std::size_t end = pattern[pos] == '{' ? pattern.find('}', pos) : pos;
+          pos = end != std::string::npos ? end + 1 : pattern.size();
+        }
+        continue;
+      }
+
+      if( c == '[' ) {
+        collector.flush();
+        pos = skipClass(pattern, pos);
+        after_quantifier = pos < pattern.size()  &&
+            (pattern[pos] == '?'  ||  pattern[pos] == '*'  ||  pattern[pos] == '+'  ||  pattern[pos] == '{');
+        if( after_quantifier ) {
+          const std::size_t end = pattern[pos] == '{' ? pattern.find('}', pos) : pos;
+          pos = end != std::string::npos ? end + 1 : pattern.size();
+        }
+        continue;
+      }
+
+      if( c == '.'  ||  c == '^'  ||  c == '$'  ||  c == ')' ) {
+        collector.flush();
+        pos++;
+        continue;
+      }
+
+      // (3) Escapes /////////////////////////////////////////////////////////
+
+      if( c == '\\' ) {
+        if( pos + 1 >= pattern.size() ) {
+          break;
+        }
+        const char e = pattern[pos + 1];
+        pos += 2;
+
+        if( !isAsciiAlnum(e) ) {
+          collector.append(e);
+          continue;
+        }
+
+        switch( e ) {
+        case 'a': collector.append('\a');   continue;
+        case 'e': collector.append('\x1B'); continue;
+        case 'f': collector.append('\f');   continue;
+        case 'n': collector.append('\n');   continue;
+        case 'r': collector.append('\r');   continue;
+        case 't': collector.append('\t');   continue;
+        case 'A': case 'B': case 'b': case 'D': case 'd': case 'G': case 'H':
+        case 'h': case 'K': case 'R': case 'S': case 's': case 'V': case 'v':
+        case 'W': case 'w': case 'X': case 'Z': case 'z':
+          collector.flush();
+          continue;
+        default:
+          break;
+        }
+
+        // NOTE: Escapes taking arguments (e.g. '\x41', '\p{L}', '\1') are not parsed;
+        //       an alternative might follow them, hence no literal is required.
+        return PatternLiterals();
+      }
+
+      // (4) Literal /////////////////////////////////////////////////////////
+
+      collector.append(c);
+      pos++;
+    }
+
+    return collector.take();
+  }
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+PatternLiterals requiredLiterals(const std::string& pattern, const MatchFlags flags)
+{
+  const bool caseInsensitive = flags.testFlag(MatchFlag::CaseInsensitive);
+  const bool         unicode = flags.testFlag(MatchFlag::Utf8);
+
+  if( flags.testFlag(MatchFlag::RegExp) ) {
+    return priv::regExpLiterals(pattern, caseInsensitive, unicode);
+  }
+
+  priv::LiteralCollector collector(caseInsensitive, unicode);
+  for(const char c : pattern) {
+    collector.append(c);
+  }
+  return collector.take();
+}
@@ -0,0 +1,194 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QDateTime>
+
+#include "ResultCache.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  std::string searchKey(const MatchJob& job)
+  {
+    if( !job.matcher ) {
+      return std::string();
+    }
+
+    const MatchFlags flags = job.matcher->flags();
+
+    std::string result;
+    result.push_back(flags.testFlag(MatchFlag::CaseInsensitive) ? 'i' : '-');
+    result.push_back(flags.testFlag(MatchFlag::FindAll)         ? 'a' : '-');
+    result.push_back(flags.testFlag(MatchFlag::RegExp)          ? 'r' : '-');
+    result.push_back(flags.testFlag(MatchFlag::Utf8)            ? 'u' : '-');
+    result += std::to_string(job.contextBefore);
+    result.push_back(',');
+    result += std::to_string(job.contextAfter);
+    result.push_back(':');
+    result += job.matcher->pattern();
+
+    return result;
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+ResultCache::ResultCache(const int maxSearches)
+  : _maxSearches{maxSearches}
+{
+}
+
+ResultCache::~ResultCache()
+{
+}
+
+void ResultCache::clear()
+{
+  const std::lock_guard<std::mutex> lock(_mutex);
+  _searches.clear();
+}
+
+bool ResultCache::lookup(const MatchJob& job, const QString& filename, const FileStamp& stamp,
+                         MatchResultPtr& result)
+{
+  result.reset();
+
+  if( !stamp.isValid() ) {
+    return false;
+  }
+
+  const std::string key = priv::searchKey(job);
+  if( key.empty() ) {
+    return false;
+  }
+
+  // (1) Find result /////////////////////////////////////////////////////////
+
+  MatchResultPtr cached;
+  {
+    const std::lock_guard<std::mutex> lock(_mutex);
+
+    const Search *search = findSearch(key, false);
+    if( search == nullptr ) {
+      return false;
+    }
+
+    const auto hit = search->entries.constFind(filename);
+    if( hit == search->entries.constEnd()  ||  hit.value().stamp != stamp ) {
+      return false;
+    }
+    cached = hit.value().result;
+  }
+
+  if( !cached  ||  (cached->paths == job.paths  &&  cached->fileId == job.fileId) ) {
+    result = cached;
+    return true;
+  }
+
+  // (2) Stamp result with the job's paths ///////////////////////////////////
+
+  // NOTE: The paths & id of a result are those of the job having built it;
+  //       the same file's job of another PathStore receives a copy.
+  std::shared_ptr<MatchResult> copy;
+  try {
+    copy = std::make_shared<MatchResult>(job);
+    copy->lines   = cached->lines;
+    copy->matches = cached->matches;
+    copy->text    = cached->text;
+  } catch(...) {
+    return false;
+  }
+  result = copy;
+
+  const std::lock_guard<std::mutex> lock(_mutex);
+
+  Search *search = findSearch(key, false);
+  if( search != nullptr ) {
+    const auto hit = search->entries.find(filename);
+    if( hit != search->entries.end()  &&  hit.value().result == cached ) {
+      hit.value().result = result;
+    }
+  }
+
+  return true;
+}
+
+void ResultCache::store(const MatchJob& job, const QString& filename, const FileStamp& stamp,
+                        const MatchResultPtr& result)
+{
+  if( !stamp.isValid()  ||  stamp.isRacy(QDateTime::currentMSecsSinceEpoch()) ) {
+    return;
+  }
+
+  const std::string key = priv::searchKey(job);
+  if( key.empty() ) {
+    return;
+  }
+
+  const std::lock_guard<std::mutex> lock(_mutex);
+
+  Search *search = findSearch(key, true);
+  if( search == nullptr ) {
+    return;
+  }
+
+  Entry& entry = search->entries[filename];
+  entry.stamp  = stamp;
+  entry.result = result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+// NOTE: '_mutex' is locked by the caller; the search found (or created)
+//       becomes the most recently used one.
+ResultCache::Search *ResultCache::findSearch(const std::string& key, const bool create)
+{
+  for(auto it = _searches.begin(); it != _searches.end(); ++it) {
+    if( it->key == key ) {
+      _searches.splice(_searches.begin(), _searches, it);
+      return &_searches.front();
+    }
+  }
+
+  if( !create  ||  _maxSearches < 1 ) {
+    return nullptr;
+  }
+
+  while( int(_searches.size()) >= _maxSearches ) {
+    _searches.pop_back();
+  }
+  _searches.emplace_front();
+  _searches.front().key = key;
+
+  return &_searches.front();
+}
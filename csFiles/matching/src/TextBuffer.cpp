@@ -89,7 +89,12 @@ TextLine TextBuffer::nextLine(const bool keepEnding, bool *ok)
       break;
     }
 
-    _cache.shift();
+    _cache.shift(historyBytes());
+    if( !canFill()  &&  !canGrow()  &&  _historyUsed > 0 ) {
+      clearHistory(); // NOTE: The current line takes precedence over the history!
+      _cache.shift();
+    }
+
     if( canFill() ) {
       if( !fillCache() ) { // Option 1: Try to fill the cache.
         return TextLine();
@@ -107,6 +112,8 @@ TextLine TextBuffer::nextLine(const bool keepEnding, bool *ok)
     line = _info.removeEnding(line);
   }
 
+  pushHistory(line);
+
   if( ok != nullptr ) {
     *ok = true;
   }
@@ -114,6 +121,36 @@ TextLine TextBuffer::nextLine(const bool keepEnding, bool *ok)
   return line;
 }
 
+TextBuffer::size_type TextBuffer::historyCount() const
+{
+  return _historyUsed > 0
+      ? _historyUsed - 1
+      : 0;
+}
+
+TextLine TextBuffer::historyLine(const size_type i) const
+{
+  if( i >= historyCount() ) {
+    return TextLine();
+  }
+  const HistoryLine& hl = _history[(_historyHead + i) % _history.size()];
+  return TextLine{_cache.at(hl.first), _cache.at(hl.second)};
+}
+
+TextBuffer::size_type TextBuffer::historySize() const
+{
+  return !_history.empty()
+      ? _history.size() - 1
+      : 0;
+}
+
+void TextBuffer::setHistorySize(const size_type size)
+{
+  clearHistory();
+  // NOTE: The ring also holds the current line!
+  _history.resize(size > 0 ? size + 1 : 0);
+}
+
 TextBufferPtr TextBuffer::create(QIODevice *device)
 {
   TextBufferPtr result(new TextBuffer(device));
@@ -148,6 +185,11 @@ bool TextBuffer::canGrow() const
   return _cache.size() < kMaxBufferSize;
 }
 
+void TextBuffer::clearHistory()
+{
+  _historyHead = _historyUsed = 0;
+}
+
 bool TextBuffer::cursorAtEof() const
 {
   return eofCached()  &&  _cache.cursor() == _cache.numUsed();
@@ -202,3 +244,31 @@ bool TextBuffer::growCache()
   const size_type s = std::min<size_type>(_cache.size()*2, kMaxBufferSize);
   return _cache.resize(s);
 }
+
+TextBuffer::size_type TextBuffer::historyBytes() const
+{
+  if( _historyUsed < 1 ) {
+    return 0;
+  }
+  const size_type oldest = _history[_historyHead].first;
+  return _cache.bottom() + _cache.cursor() - oldest;
+}
+
+void TextBuffer::pushHistory(const TextLine& line)
+{
+  if( _history.empty() ) {
+    return;
+  }
+
+  const char *base = _cache.at(_cache.bottom());
+  const HistoryLine hl{_cache.bottom() + static_cast<size_type>(line.first  - base),
+                       _cache.bottom() + static_cast<size_type>(line.second - base)};
+
+  if( _historyUsed < _history.size() ) {
+    _history[(_historyHead + _historyUsed) % _history.size()] = hl;
+    _historyUsed += 1;
+  } else {
+    _history[_historyHead] = hl;
+    _historyHead = (_historyHead + 1) % _history.size();
+  }
+}
@@ -0,0 +1,787 @@
+/****************************************************************************
+** Copyright (c) 2020, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+
+#include "FindEntry.h"
+#include "FindJob.h"
+#include "Trigrams.h"
+
+#include "TrigramIndex.h"
+
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr char kMagic[8] = {'c', 's', 'F', 'T', 'R', 'I', 'G', '\0'};
+
+constexpr uint32_t kVersion = 1;
+
+constexpr uint32_t kNoFile = std::numeric_limits<uint32_t>::max();
+
+constexpr std::size_t kBlockSize = 256; // Files read in parallel
+
+constexpr qint64 kMaxFileSize = 64*1024*1024;
+
+// NOTE: A file modified this close to the index's creation may have been
+//       modified again within the same timestamp; it is read again.
+constexpr int64_t kRacyInterval = 2000; // [ms]
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t rootSize;
+    uint64_t numFiles;
+    uint64_t numTrigrams;
+    uint64_t pathsSize;
+    uint64_t postingsSize;
+    int64_t  created; // [ms] since epoch
+    uint64_t reserved;
+  };
+
+  static_assert(sizeof(Header) == 64, "Invalid size of trigram index header!");
+
+  using Trigrams = std::vector<uint32_t>;
+
+  void appendVarint(std::string& out, uint32_t value)
+  {
+    while( value >= 0x80 ) {
+      out.push_back(char((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(char(value));
+  }
+
+  // NOTE: Appends the delta encoded 'ids' to 'out'.
+  void encodePostings(std::string& out, const std::vector<uint32_t>& ids)
+  {
+    uint32_t prev = 0;
+    for(const uint32_t id : ids) {
+      appendVarint(out, id - prev);
+      prev = id;
+    }
+  }
+
+  std::vector<uint32_t> decodePostings(const std::string_view& postings, std::size_t pos,
+                                       const uint32_t count, const std::size_t numFiles)
+  {
+    std::vector<uint32_t> result;
+    result.reserve(count);
+
+    uint64_t prev = 0;
+    for(uint32_t i = 0; i < count  &&  pos < postings.size(); i++) {
+      uint64_t delta = 0;
+      for(int shift = 0; pos < postings.size()  &&  shift < 35; shift += 7) {
+        const unsigned char b = static_cast<unsigned char>(postings[pos++]);
+        delta |= uint64_t(b & 0x7F) << shift;
+        if( (b & 0x80) == 0 ) {
+          break;
+        }
+      }
+      prev += delta;
+      if( prev >= numFiles ) {
+        break;
+      }
+      result.push_back(uint32_t(prev));
+    }
+
+    return result;
+  }
+
+  bool readTrigrams(const std::string& filePath, const qint64 size, Trigrams& trigrams,
+                    std::vector<uint64_t>& bitmap)
+  {
+    trigrams.clear();
+    if( size > kMaxFileSize ) {
+      return false;
+    }
+
+    QFile file(QString::fromStdString(filePath));
+    if( !file.open(QIODevice::ReadOnly) ) {
+      return false;
+    }
+
+    // NOTE: A mapping would fault if the file was truncated meanwhile!
+    const QByteArray buffer = file.readAll();
+    const char      *data = buffer.constData();
+    const qint64  numData = buffer.size();
+
+    // NOTE: Duplicates are removed by a bitmap of all trigrams; only the
+    //       words touched are collected and cleared again.
+    if( bitmap.size() != kNumTrigrams/64 ) {
+      bitmap.assign(kNumTrigrams/64, 0);
+    }
+    std::vector<uint32_t> touched;
+    forEachTrigram(data, data + numData, [&](const uint32_t t) -> void {
+      uint64_t& word = bitmap[t/64];
+      if( word == 0 ) {
+        touched.push_back(t/64);
+      }
+      word |= uint64_t(1) << (t%64);
+    });
+    std::sort(touched.begin(), touched.end());
+    for(const uint32_t w : touched) {
+      for(uint64_t bits = bitmap[w]; bits != 0; bits &= bits - 1) {
+        int bit = 0;
+        while( ((bits >> bit) & 1) == 0 ) {
+          bit++;
+        }
+        trigrams.push_back(w*64 + uint32_t(bit));
+      }
+      bitmap[w] = 0;
+    }
+
+    return true;
+  }
+
+  bool statFile(const std::string& filePath, uint64_t& size, int64_t& lastModified)
+  {
+    const std::string::size_type slash = filePath.rfind('/');
+    if( slash == std::string::npos ) {
+      return false;
+    }
+
+    FindEntry entry;
+    entry.setDirectory(std::string_view(filePath).substr(0, slash > 0 ? slash : 1));
+    entry.setName(std::string_view(filePath).substr(slash + 1), FindType::Unknown);
+
+    const FindMetadata& metadata = entry.metadata(FindMetadata::Size | FindMetadata::LastModified);
+    if( !entry.hasMetadata() ) {
+      return false;
+    }
+
+    size = metadata.size;
+    lastModified = metadata.lastModified;
+
+    return true;
+  }
+
+  bool write(QSaveFile& file, const void *data, const std::size_t size)
+  {
+    return size < 1  ||
+        file.write(reinterpret_cast<const char*>(data), qint64(size)) == qint64(size);
+  }
+
+} // namespace priv
+
+////// TrigramIndexBuilder ///////////////////////////////////////////////////
+
+// NOTE: Builds a new index from the tree and an (optional) old index; the
+//       postings of unmodified files are taken from the old index.
+
+class TrigramIndexBuilder {
+public:
+  TrigramIndexBuilder(const TrigramIndex *old, const std::string& rootPath)
+    : _old(old)
+    , _rootPath(rootPath)
+  {
+  }
+
+  std::shared_ptr<TrigramIndex> build(bool *changed)
+  {
+    std::shared_ptr<TrigramIndex> result(new TrigramIndex());
+    result->_created = QDateTime::currentMSecsSinceEpoch();
+
+    // (1) Find files ////////////////////////////////////////////////////////
+
+    if( !listFiles(result.get()) ) {
+      return std::shared_ptr<TrigramIndex>();
+    }
+
+    const bool dirty = _old == nullptr  ||  !_pending.empty()  ||
+        _numReused != _old->fileCount();
+    if( changed != nullptr ) {
+      *changed = dirty;
+    }
+    if( !dirty ) {
+      return result;
+    }
+
+    // (2) Read new & modified files /////////////////////////////////////////
+
+    readFiles(result.get());
+
+    // (3) Merge postings ////////////////////////////////////////////////////
+
+    mergePostings(result.get());
+
+    // (4) Views /////////////////////////////////////////////////////////////
+
+    result->_files       = result->_fileStorage.data();
+    result->_numFiles    = result->_fileStorage.size();
+    result->_trigrams    = result->_trigramStorage.data();
+    result->_numTrigrams = result->_trigramStorage.size();
+    result->_paths       = std::string_view(result->_pathStorage);
+    result->_postings    = std::string_view(result->_postingStorage);
+    result->_rootSize    = _rootPath.size();
+
+    return result;
+  }
+
+private:
+  struct Posting {
+    std::string data;
+    uint32_t last{0};
+    uint32_t count{0};
+  };
+
+  std::string filePath(const std::string& relPath) const
+  {
+    std::string result(_rootPath);
+    if( result.back() != '/' ) {
+      result.push_back('/');
+    }
+    result.append(relPath);
+    return result;
+  }
+
+  bool listFiles(TrigramIndex *index)
+  {
+    FindFlags flags{FindFlag::NoFlags};
+    flags.set(FindFlag::Files, true);
+    flags.set(FindFlag::Subdirectories, true);
+
+    const FindJob job(QString::fromStdString(_rootPath), flags);
+
+    FindStatistics stats;
+    const QStringList found = executeFind(job, &stats);
+    if( stats.directories < 1 ) {
+      return false;
+    }
+
+    const std::size_t prefix = _rootPath.back() == '/'
+        ? _rootPath.size()
+        : _rootPath.size() + 1;
+
+    std::vector<std::string> relPaths;
+    relPaths.reserve(std::size_t(found.size()));
+    for(const QString& path : found) {
+      const std::string s = path.toStdString();
+      if( s.size() > prefix  &&  s.compare(0, _rootPath.size(), _rootPath) == 0 ) {
+        relPaths.push_back(s.substr(prefix));
+      }
+    }
+    std::sort(relPaths.begin(), relPaths.end());
+
+    if( _old != nullptr ) {
+      _oldToNew.assign(_old->fileCount(), kNoFile);
+    }
+
+    index->_pathStorage.assign(_rootPath);
+    for(const std::string& relPath : relPaths) {
+      const std::string path = filePath(relPath);
+
+      TrigramIndex::File file{0, 0, 0, 0, 0, 0};
+      if( !priv::statFile(path, file.size, file.lastModified) ) {
+        continue;
+      }
+      file.path     = uint32_t(index->_pathStorage.size());
+      file.pathSize = uint32_t(relPath.size());
+      index->_pathStorage.append(relPath);
+
+      const uint32_t id = uint32_t(index->_fileStorage.size());
+      const int64_t oldId = _old != nullptr
+          ? _old->findFile(path)
+          : -1;
+      if( oldId >= 0  &&  isUnmodified(_old->_files[oldId], file) ) {
+        file.flags = _old->_files[oldId].flags;
+        _oldToNew[std::size_t(oldId)] = id;
+        _numReused++;
+      } else {
+        _pending.push_back(id);
+      }
+
+      index->_fileStorage.push_back(file);
+    }
+
+    return index->_fileStorage.size() < kNoFile  &&  index->_pathStorage.size() < kNoFile;
+  }
+
+  bool isUnmodified(const TrigramIndex::File& oldFile, const TrigramIndex::File& file) const
+  {
+    return oldFile.size == file.size  &&  oldFile.lastModified == file.lastModified  &&
+        file.lastModified + kRacyInterval < _old->_created;
+  }
+
+  void mergePostings(TrigramIndex *index)
+  {
+    std::vector<uint32_t> keys;
+    keys.reserve(_postings.size());
+    for(const auto& posting : _postings) {
+      keys.push_back(posting.first);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    const std::size_t numOld = _old != nullptr
+        ? _old->trigramCount()
+        : 0;
+
+    std::vector<uint32_t> oldIds;
+    std::vector<uint32_t> newIds;
+    std::vector<uint32_t> ids;
+
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while( i < numOld  ||  j < keys.size() ) {
+      const uint32_t oldKey = i < numOld ? _old->_trigrams[i].trigram : kNoFile;
+      const uint32_t newKey = j < keys.size() ? keys[j] : kNoFile;
+      const uint32_t trigram = std::min(oldKey, newKey);
+
+      oldIds.clear();
+      if( oldKey == trigram ) {
+        for(const uint32_t oldId : _old->decode(_old->_trigrams[i])) {
+          if( _oldToNew[oldId] != kNoFile ) {
+            oldIds.push_back(_oldToNew[oldId]);
+          }
+        }
+        i++;
+      }
+
+      newIds.clear();
+      if( newKey == trigram ) {
+        const Posting& posting = _postings[newKey];
+        newIds = priv::decodePostings(posting.data, 0, posting.count, index->_fileStorage.size());
+        j++;
+      }
+
+      ids.resize(oldIds.size() + newIds.size());
+      std::merge(oldIds.cbegin(), oldIds.cend(), newIds.cbegin(), newIds.cend(), ids.begin());
+      if( ids.empty() ) {
+        continue;
+      }
+
+      index->_trigramStorage.push_back(TrigramIndex::Trigram{trigram, uint32_t(ids.size()),
+                                                             uint64_t(index->_postingStorage.size())});
+      priv::encodePostings(index->_postingStorage, ids);
+    }
+  }
+
+  void readFiles(TrigramIndex *index)
+  {
+    const std::size_t numThreads = std::size_t(qMax<int>(1, QThread::idealThreadCount()));
+
+    std::vector<priv::Trigrams> trigrams(kBlockSize);
+    std::vector<char> indexed(kBlockSize);
+
+    for(std::size_t first = 0; first < _pending.size(); first += kBlockSize) {
+      const std::size_t count = std::min(kBlockSize, _pending.size() - first);
+
+      // (1) Read block in parallel //////////////////////////////////////////
+
+      std::atomic<std::size_t> next{0};
+      auto worker = [&]() -> void {
+        std::vector<uint64_t> bitmap;
+        std::size_t k;
+        while( (k = next.fetch_add(1)) < count ) {
+          const TrigramIndex::File& file = index->_fileStorage[_pending[first + k]];
+          const std::string path =
+              filePath(index->_pathStorage.substr(file.path, file.pathSize));
+          indexed[k] = priv::readTrigrams(path, qint64(file.size), trigrams[k], bitmap);
+        }
+      };
+
+      std::vector<std::thread> threads;
+      for(std::size_t t = 1; t < numThreads; t++) {
+        threads.emplace_back(worker);
+      }
+      worker();
+      for(std::thread& thread : threads) {
+        thread.join();
+      }
+
+      // (2) Append postings in order of files ///////////////////////////////
+
+      for(std::size_t k = 0; k < count; k++) {
+        const uint32_t id = _pending[first + k];
+        if( !indexed[k] ) {
+          index->_fileStorage[id].flags |= TrigramIndex::Unindexed;
+          continue;
+        }
+        for(const uint32_t t : trigrams[k]) {
+          Posting& posting = _postings[t];
+          priv::appendVarint(posting.data, id - posting.last);
+          posting.last = id;
+          posting.count++;
+        }
+      }
+    }
+  }
+
+  const TrigramIndex *_old{nullptr};
+  const std::string& _rootPath;
+  std::vector<uint32_t> _oldToNew{};
+  std::size_t _numReused{0};
+  std::vector<uint32_t> _pending{};
+  std::unordered_map<uint32_t,Posting> _postings{};
+};
+
+////// TrigramIndex - public /////////////////////////////////////////////////
+
+TrigramIndex::~TrigramIndex()
+{
+}
+
+bool TrigramIndex::candidates(const PatternLiterals& literals, std::vector<bool>& result) const
+{
+  result.clear();
+
+  // (1) Trigrams of all literals ////////////////////////////////////////////
+
+  std::vector<uint32_t> wanted;
+  for(const std::string& literal : literals) {
+    forEachTrigram(literal.data(), literal.data() + literal.size(), [&](const uint32_t t) -> void {
+      wanted.push_back(t);
+    });
+  }
+  if( wanted.empty() ) {
+    return false;
+  }
+  std::sort(wanted.begin(), wanted.end());
+  wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+
+  // (2) Intersect postings; rarest trigram first ////////////////////////////
+
+  std::vector<const Trigram*> postings;
+  bool missing = false;
+  for(const uint32_t t : wanted) {
+    const Trigram *trigram = findTrigram(t);
+    if( trigram == nullptr ) {
+      missing = true;
+      break;
+    }
+    postings.push_back(trigram);
+  }
+
+  std::vector<uint32_t> ids;
+  if( !missing ) {
+    std::sort(postings.begin(), postings.end(), [](const Trigram *a, const Trigram *b) -> bool {
+      return a->count < b->count;
+    });
+
+    ids = decode(*postings.front());
+    std::vector<uint32_t> other;
+    std::vector<uint32_t> common;
+    for(std::size_t i = 1; i < postings.size()  &&  !ids.empty(); i++) {
+      other = decode(*postings[i]);
+      common.clear();
+      std::set_intersection(ids.cbegin(), ids.cend(), other.cbegin(), other.cend(),
+                            std::back_inserter(common));
+      ids.swap(common);
+    }
+  }
+
+  // (3) Candidates; unindexed files always are //////////////////////////////
+
+  result.assign(_numFiles, false);
+  for(const uint32_t id : ids) {
+    result[id] = true;
+  }
+  for(std::size_t i = 0; i < _numFiles; i++) {
+    if( (_files[i].flags & Unindexed) != 0 ) {
+      result[i] = true;
+    }
+  }
+
+  return true;
+}
+
+std::size_t TrigramIndex::fileCount() const
+{
+  return _numFiles;
+}
+
+int64_t TrigramIndex::findFile(const std::string_view& filePath) const
+{
+  const std::string_view root = rootPath();
+  if( root.empty()  ||  filePath.size() <= root.size()  ||
+      filePath.compare(0, root.size(), root) != 0 ) {
+    return -1;
+  }
+
+  std::string_view relPath = filePath.substr(root.size());
+  if( root.back() != '/' ) {
+    if( relPath.front() != '/' ) {
+      return -1;
+    }
+    relPath.remove_prefix(1);
+  }
+
+  const File *last = _files + _numFiles;
+  const File *hit = std::lower_bound(_files, last, relPath, [this](const File& f, const std::string_view& s) -> bool {
+    return path(f) < s;
+  });
+
+  return hit != last  &&  path(*hit) == relPath
+      ? int64_t(hit - _files)
+      : -1;
+}
+
+std::string_view TrigramIndex::rootPath() const
+{
+  return _paths.substr(0, _rootSize);
+}
+
+std::size_t TrigramIndex::trigramCount() const
+{
+  return _numTrigrams;
+}
+
+TrigramIndexPtr TrigramIndex::update(const QString& filename, const std::string& rootPath,
+                                     bool *changed)
+{
+  if( changed != nullptr ) {
+    *changed = false;
+  }
+
+  // (1) Load old index //////////////////////////////////////////////////////
+
+  std::shared_ptr<TrigramIndex> old(new TrigramIndex());
+  if( !old->load(filename)  ||  old->rootPath() != rootPath ) {
+    old.reset();
+  }
+
+  // (2) Revalidate //////////////////////////////////////////////////////////
+
+  bool dirty = false;
+  std::shared_ptr<TrigramIndex> result = TrigramIndexBuilder(old.get(), rootPath).build(&dirty);
+  if( !result ) {
+    return TrigramIndexPtr();
+  }
+
+  if( !dirty ) {
+    return old;
+  }
+
+  // (3) Save new index //////////////////////////////////////////////////////
+
+  // NOTE: The old index must be unmapped prior to replacing its file!
+  old.reset();
+
+  result->save(filename);
+
+  if( changed != nullptr ) {
+    *changed = true;
+  }
+
+  return result;
+}
+
+////// TrigramIndex - private ////////////////////////////////////////////////
+
+std::vector<uint32_t> TrigramIndex::decode(const Trigram& trigram) const
+{
+  return priv::decodePostings(_postings, std::size_t(trigram.offset), trigram.count, _numFiles);
+}
+
+const TrigramIndex::Trigram *TrigramIndex::findTrigram(const uint32_t trigram) const
+{
+  const Trigram *last = _trigrams + _numTrigrams;
+  const Trigram *hit = std::lower_bound(_trigrams, last, trigram, [](const Trigram& t, const uint32_t value) -> bool {
+    return t.trigram < value;
+  });
+  return hit != last  &&  hit->trigram == trigram
+      ? hit
+      : nullptr;
+}
+
+bool TrigramIndex::load(const QString& filename)
+{
+  // (1) Map file ////////////////////////////////////////////////////////////
+
+  _file.setFileName(filename);
+  if( !_file.open(QIODevice::ReadOnly) ) {
+    return false;
+  }
+
+  const qint64 fileSize = _file.size();
+  if( fileSize < qint64(sizeof(priv::Header)) ) {
+    return false;
+  }
+
+  const uchar *data = _file.map(0, fileSize);
+  if( data == nullptr ) {
+    return false;
+  }
+
+  // (2) Validate header /////////////////////////////////////////////////////
+
+  priv::Header header;
+  std::memcpy(&header, data, sizeof(priv::Header));
+  if( std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0  ||  header.version != kVersion ) {
+    return false;
+  }
+
+  if( header.numFiles >= kNoFile  ||  header.numTrigrams > kNumTrigrams  ||
+      header.pathsSize >= kNoFile  ||  header.rootSize > header.pathsSize ) {
+    return false;
+  }
+
+  const uint64_t expected = sizeof(priv::Header) +
+      header.numFiles*sizeof(File) + header.numTrigrams*sizeof(Trigram) +
+      header.pathsSize + header.postingsSize;
+  if( uint64_t(fileSize) != expected ) {
+    return false;
+  }
+
+  // (3) Setup views /////////////////////////////////////////////////////////
+
+  const uchar *tables = data + sizeof(priv::Header);
+  const std::size_t filesSize    = std::size_t(header.numFiles)*sizeof(File);
+  const std::size_t trigramsSize = std::size_t(header.numTrigrams)*sizeof(Trigram);
+
+  _files       = reinterpret_cast<const File*>(tables);
+  _numFiles    = std::size_t(header.numFiles);
+  _trigrams    = reinterpret_cast<const Trigram*>(tables + filesSize);
+  _numTrigrams = std::size_t(header.numTrigrams);
+  _paths       = std::string_view(reinterpret_cast<const char*>(tables + filesSize + trigramsSize),
+                                  std::size_t(header.pathsSize));
+  _postings    = std::string_view(reinterpret_cast<const char*>(tables + filesSize + trigramsSize +
+                                                                header.pathsSize),
+                                  std::size_t(header.postingsSize));
+  _rootSize    = header.rootSize;
+  _created     = header.created;
+
+  // (4) Validate tables; postings are validated when decoded ////////////////
+
+  for(std::size_t i = 0; i < _numFiles; i++) {
+    if( uint64_t(_files[i].path) + _files[i].pathSize > _paths.size() ) {
+      return false;
+    }
+  }
+
+  for(std::size_t i = 0; i < _numTrigrams; i++) {
+    if( _trigrams[i].offset > _postings.size() ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::string_view TrigramIndex::path(const File& file) const
+{
+  return _paths.substr(file.path, file.pathSize);
+}
+
+bool TrigramIndex::save(const QString& filename) const
+{
+  QSaveFile file(filename);
+  if( !file.open(QIODevice::WriteOnly) ) {
+    return false;
+  }
+
+  priv::Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version      = kVersion;
+  header.rootSize     = uint32_t(_rootSize);
+  header.numFiles     = _numFiles;
+  header.numTrigrams  = _numTrigrams;
+  header.pathsSize    = _paths.size();
+  header.postingsSize = _postings.size();
+  header.created      = _created;
+  header.reserved     = 0;
+
+  if( !priv::write(file, &header, sizeof(priv::Header))  ||
+      !priv::write(file, _files, _numFiles*sizeof(File))  ||
+      !priv::write(file, _trigrams, _numTrigrams*sizeof(Trigram))  ||
+      !priv::write(file, _paths.data(), _paths.size())  ||
+      !priv::write(file, _postings.data(), _postings.size()) ) {
+    file.cancelWriting();
+    return false;
+  }
+
+  return file.commit();
+}
+
+////// TrigramFilter - public ////////////////////////////////////////////////
+
+TrigramFilter::~TrigramFilter()
+{
+}
+
+IFindFilterPtr TrigramFilter::clone() const
+{
+  return IFindFilterPtr(new TrigramFilter(*this));
+}
+
+const char *TrigramFilter::name() const
+{
+  return "trigram";
+}
+
+IFindFilterPtr TrigramFilter::create(const TrigramIndexPtr& index, const PatternLiterals& literals)
+{
+  TrigramFilter *filter = new TrigramFilter(index);
+  if( index ) {
+    std::vector<bool> candidates;
+    if( index->candidates(literals, candidates) ) {
+      filter->_candidates = std::make_shared<const std::vector<bool>>(std::move(candidates));
+    }
+  }
+  return IFindFilterPtr(filter);
+}
+
+////// TrigramFilter - protected /////////////////////////////////////////////
+
+bool TrigramFilter::isActive() const
+{
+  return _index  &&  _candidates;
+}
+
+bool TrigramFilter::isMatch(const FindEntry& entry) const
+{
+  if( entry.isDir() ) {
+    return true;
+  }
+  const int64_t id = _index->findFile(entry.filePathView());
+  return id < 0  ||  (*_candidates)[std::size_t(id)];
+}
+
+////// TrigramFilter - private ///////////////////////////////////////////////
+
+TrigramFilter::TrigramFilter(const TrigramIndexPtr& index)
+  : IFindFilter(false)
+  , _index(index)
+{
+}
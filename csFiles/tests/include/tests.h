@@ -1,8 +1,12 @@
 #ifndef TESTS_H
 #define TESTS_H
 
+void run_bloom_tests();
+
 void run_file_tests();
 
+void run_literals_tests();
+
 void run_re_tests();
 
 #endif // TESTS_H
@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include <string>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include "tests.h"
+
+#include "BloomCache.h"
+#include "PatternLiterals.h"
+
+void run_bloom(const QString& cachePath, const QString& filename, const std::string& pattern,
+               const BloomCache::Status ref)
+{
+  MatchFlags flags{MatchFlag::RegExp};
+
+  const BloomCachePtr cache = BloomCache::create(cachePath, requiredLiterals(pattern, flags));
+  const BloomCache::Status status = cache->lookup(filename, FileStamp::of(filename));
+
+  printf("\"%s\": %d: %s\n", pattern.data(), int(status), status == ref ? "OK" : "not OK");
+}
+
+void run_bloom_tests()
+{
+  const QString cachePath = QDir::temp().filePath(QStringLiteral("csFiles-bloom-tests"));
+  const QString  filename = QDir::temp().filePath(QStringLiteral("csFiles-bloom-tests.txt"));
+
+  const std::string text("xyz\n");
+
+  QFile file(filename);
+  if( !file.open(QIODevice::WriteOnly)  ||
+      file.write(text.data(), qint64(text.size())) != qint64(text.size()) ) {
+    printf("ERROR: Unable to write file \"%s\"!\n", qPrintable(filename));
+    return;
+  }
+  file.close();
+
+  const FileStamp stamp = FileStamp::of(filename);
+  {
+    BloomBuilder builder(qint64(text.size()));
+    builder.add(TextLine{text.data(), text.data() + text.size()});
+    BloomCache::create(cachePath, PatternLiterals())->store(filename, stamp, builder);
+  }
+
+  run_bloom(cachePath, filename, "xyz", BloomCache::Status::Accepted);
+  run_bloom(cachePath, filename, "abcd", BloomCache::Status::Rejected);
+
+  // NOTE: The file matches each alternative following an escape not parsed.
+
+  run_bloom(cachePath, filename, "abcd\\x41|xyz", BloomCache::Status::Accepted);
+  run_bloom(cachePath, filename, "abcd\\1|xyz", BloomCache::Status::Accepted);
+  run_bloom(cachePath, filename, "abcd\\p{L}|xyz", BloomCache::Status::Accepted);
+
+  QDir(cachePath).removeRecursively();
+  QFile::remove(filename);
+
+  fflush(stdout);
+}
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include <string>
+
+#include "tests.h"
+
+#include "PatternLiterals.h"
+
+void run_literals(const std::string& pattern, const MatchFlags flags, const PatternLiterals& ref)
+{
+  const PatternLiterals literals = requiredLiterals(pattern, flags);
+
+  printf("\"%s\":", pattern.data());
+  for(const std::string& literal : literals) {
+    printf(" \"%s\"", literal.data());
+  }
+  printf(": %s\n", literals == ref ? "OK" : "not OK");
+}
+
+void run_literals_tests()
+{
+  MatchFlags bytes{MatchFlag::RegExp};
+
+  MatchFlags utf8{MatchFlag::RegExp};
+  utf8.set(MatchFlag::Utf8, true);
+
+  // NOTE: U+00E9 LATIN SMALL LETTER E WITH ACUTE is encoded as 0xC3 0xA9.
+
+  run_literals("ab\xC3\xA9?cd", utf8, PatternLiterals{"ab", "cd"});
+  run_literals("ab\xC3\xA9*cd", utf8, PatternLiterals{"ab", "cd"});
+  run_literals("ab\xC3\xA9{0,2}cd", utf8, PatternLiterals{"ab", "cd"});
+  run_literals("ab\xC3\xA9+cd", utf8, PatternLiterals{"ab\xC3\xA9", "\xC3\xA9" "cd"});
+
+  // NOTE: Without UTF-8, a quantifier applies to the last byte only.
+
+  run_literals("ab\xC3\xA9?cd", bytes, PatternLiterals{"ab\xC3", "cd"});
+  run_literals("ab\xC3\xA9+cd", bytes, PatternLiterals{"ab\xC3\xA9", "\xA9" "cd"});
+
+  // NOTE: Escapes taking arguments are not parsed; an alternative may follow.
+
+  run_literals("abcd\\x41|xyz", bytes, PatternLiterals());
+  run_literals("abcd\\1|xyz", bytes, PatternLiterals());
+  run_literals("abcd\\p{L}|xyz", bytes, PatternLiterals());
+  run_literals("abcd\\Qe|f\\E", bytes, PatternLiterals());
+
+  fflush(stdout);
+}
@@ -32,10 +32,18 @@
 #ifndef FILESMODEL_H
 #define FILESMODEL_H
 
+#include <utility>
+#include <vector>
+
 #include <QtCore/QAbstractListModel>
 #include <QtCore/QDir>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QMimeDatabase>
 #include <QtWidgets/QFileIconProvider>
 
+#include "PathStore.h"
+
 class FilesModel : public QAbstractListModel {
   Q_OBJECT
 public:
@@ -48,24 +56,54 @@ public:
   int rowCount(const QModelIndex& parent = QModelIndex()) const;
 
   void append(const QStringList& files);
+  void append(const FileIds& files);
+  void append(const PathStorePtr& paths, const FileIds& files);
   void clear();
   void clearRoot();
+  FileId fileId(const QModelIndex& index) const;
+  const FileIds& fileIds() const;
   QStringList files() const;
-  void remove(const QStringList& files);
+  const PathStorePtr& paths() const;
+  void remove(FileIds files);
   QString rootPath() const;
   bool setRoot(const QDir& root);
 
   bool listFilesOnly() const;
   void setListFilesOnly(const bool on);
 
+private slots:
+  void resolveKinds();
+  void storeKinds();
+
 private:
+  enum Kind : unsigned char {
+    Unknown = 0,
+    Pending,
+    File,
+    Directory
+  };
+
+  using Kinds = std::vector<std::pair<FileId,Kind>>;
+
+  QIcon icon(const FileId id) const;
+  Kind kind(const FileId id) const;
   void refreshModel();
 
-  QVector<QString> _files;
+  // NOTE: Ordered by PathStore::isLess()!
+  FileIds _files;
   QFileIconProvider _iconProvider;
+  QMimeDatabase _mimeDb;
+  PathStorePtr _paths{};
   bool _listFilesOnly{false};
-  QDir _root;
+  FileId _rootId{0};
   QString _rootPath;
+  // NOTE: Caches to keep data() off the file system; kinds are indexed by FileId.
+  mutable QHash<QString,QIcon> _icons;
+  mutable std::vector<Kind> _kinds;
+  mutable FileIds _pendingKinds;
+  QFutureWatcher<Kinds> _kindsWatcher;
+  QIcon _dirIcon;
+  QIcon _fileIcon;
 };
 
 #endif // FILESMODEL_H
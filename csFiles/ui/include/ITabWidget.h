@@ -34,6 +34,8 @@
 
 #include <QtWidgets/QWidget>
 
+#include "PathStore.h"
+
 class ITabWidget : public QWidget {
   Q_OBJECT
 public:
@@ -47,7 +49,7 @@ protected slots:
 
 signals:
   void editFileRequested(const QString& filename, int line);
-  void grepRequested(const QString& rootPath, const QStringList& files);
+  void grepRequested(const QString& rootPath, const PathStorePtr& paths, const FileIds& files);
   void openLocationRequested(const QString& path);
   void tabLabelChanged(const QString&);
 };
@@ -32,62 +32,49 @@
 #ifndef MATCHRESULTSMODEL_H
 #define MATCHRESULTSMODEL_H
 
-#include <QtCore/QDir>
+#include <vector>
 
-#include <csQt/csAbstractTreeItem.h>
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QDir>
 
 #include "MatchJob.h"
 
-class MatchResultsItem : public csAbstractTreeItem {
-public:
-  MatchResultsItem(csAbstractTreeItem *parent = nullptr);
-  ~MatchResultsItem() = default;
-
-  int columnCount() const;
-};
-
-class MatchResultsRoot : public MatchResultsItem {
+class MatchResultsModel : public QAbstractItemModel {
+  Q_OBJECT
 public:
-  MatchResultsRoot(const QString& rootPath);
-  ~MatchResultsRoot() = default;
-
-  QVariant data(int column, int role) const;
-
+  MatchResultsModel(QObject *parent);
+  ~MatchResultsModel();
+
+  bool canFetchMore(const QModelIndex& parent) const;
+  int columnCount(const QModelIndex& parent = QModelIndex()) const;
+  QVariant data(const QModelIndex& index, int role) const;
+  void fetchMore(const QModelIndex& parent);
+  bool hasChildren(const QModelIndex& parent = QModelIndex()) const;
+  QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+  QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const;
+  QModelIndex parent(const QModelIndex& index) const;
+  int rowCount(const QModelIndex& parent = QModelIndex()) const;
+
+  void clear();
   QString displayFilename(const QString& filename) const;
-
-  QStringList files() const;
-
+  QString filename(const QModelIndex& index) const;
+  FileIds fileIds() const;
+  int lineNumber(const QModelIndex& index) const;
   QString rootPath() const;
+  void setResults(MatchResults results, const QString& rootPath);
 
 private:
+  int fileRow(const QModelIndex& index) const;
+  bool isFile(const QModelIndex& index) const;
+  bool isLine(const QModelIndex& index) const;
+
+  // NOTE: Files are made known to the view in batches; see fetchMore()!
+  //       The lines of a file are all known as soon as it is expanded,
+  //       as the view only fetches more of the last expanded file.
+  std::vector<MatchResultPtr> _results;
+  int _fetchedFiles{0};
   QDir _root;
   QString _rootPath;
 };
 
-class MatchResultsFile : public MatchResultsItem {
-public:
-  MatchResultsFile(const QString& filename, MatchResultsRoot *parent);
-  ~MatchResultsFile() = default;
-
-  QVariant data(int column, int role) const;
-
-  QString filename() const;
-
-private:
-  QString _filename;
-};
-
-class MatchResultsLine : public MatchResultsItem {
-public:
-  MatchResultsLine(const MatchedLine& line, MatchResultsFile *parent);
-  ~MatchResultsLine() = default;
-
-  QVariant data(int column, int role) const;
-
-  int number() const;
-
-private:
-  MatchedLine _line;
-};
-
 #endif // MATCHRESULTSMODEL_H
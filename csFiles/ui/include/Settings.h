@@ -63,12 +63,15 @@ namespace Settings {
   namespace find {
 
     extern Presets extensions;
+    extern QString watchedRoot; // Kept in a LiveIndex, if set
 
   } // namespace find
 
   namespace grep {
 
+    extern QString bloomCache; // Directory of cached filters, if set
     extern bool copyLocationDisplayName;
+    extern int corpusCacheSize; // [MiB] Shared by all views; 0 disables
 
   } // namespace grep
 
@@ -34,6 +34,8 @@
 
 #include <csQt/csWListEditor.h>
 
+#include "PathStore.h"
+
 class QDir;
 
 class WFileList : public csWListEditor {
@@ -75,7 +77,9 @@ public:
 
   int count() const;
 
+  const FileIds& fileIds() const;
   QStringList files() const;
+  const PathStorePtr& paths() const;
 
   QString rootPath() const;
 
@@ -83,6 +87,8 @@ public slots:
   void appendFiles(const QStringList& files);
   void appendFiles(const QDir& root, const QStringList& files);
   void appendFiles(const QString& rootPath, const QStringList& files);
+  void appendFiles(const PathStorePtr& paths, const FileIds& files);
+  void appendFiles(const QString& rootPath, const PathStorePtr& paths, const FileIds& files);
   void clearList();
   void clearRoot();
   void copyList();
@@ -32,7 +32,12 @@
 #ifndef WFIND_H
 #define WFIND_H
 
+#include <atomic>
+
+#include <QtCore/QFutureWatcher>
+
 #include "ITabWidget.h"
+#include "PathStore.h"
 
 namespace Ui {
   class WFind;
@@ -50,14 +55,23 @@ private slots:
   void browse();
   void clearResults();
   void executeFind();
+  void findFinished();
   void setExtension();
   void setTabLabel(const QString& text);
   void showResultsContextMenu(const QPoint& p);
+  void stopFind();
 
 private:
   Ui::WFind *ui{nullptr};
   QAction *_completeSuffixAction{nullptr};
   class FilesModel *_resultsModel{nullptr};
+  QFutureWatcher<void> _findWatcher;
+  std::atomic<bool> _cancelFind{false};
+  quint64 _findGeneration{0};
+
+signals:
+  // NOTE: Emitted from the find's worker threads!
+  void resultsFound(const FileIds& files, const quint64 generation);
 };
 
 #endif // WFIND_H
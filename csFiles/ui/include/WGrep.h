@@ -34,8 +34,9 @@
 
 #include "ITabWidget.h"
 
-class csTreeModel;
+class MatchResultsModel;
 class QDir;
+class ResultCache;
 
 namespace Ui {
   class WGrep;
@@ -53,6 +54,8 @@ public slots:
   void appendFiles(const QStringList& files);
   void appendFiles(const QDir& root, const QStringList& files);
   void appendFiles(const QString& rootPath, const QStringList& files);
+  void appendFiles(const PathStorePtr& paths, const FileIds& files);
+  void appendFiles(const QString& rootPath, const PathStorePtr& paths, const FileIds& files);
 
 private slots:
   void clearResults();
@@ -67,7 +70,8 @@ private:
   bool tryCompile();
 
   Ui::WGrep *ui{nullptr};
-  csTreeModel *_resultsModel{nullptr};
+  MatchResultsModel *_resultsModel{nullptr};
+  ResultCache *_resultCache{nullptr}; // Reused by the next grep
 };
 
 #endif // WGREP_H
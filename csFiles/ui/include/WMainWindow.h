@@ -34,6 +34,8 @@
 
 #include <QtWidgets/QMainWindow>
 
+#include "PathStore.h"
+
 class ITabWidget;
 
 namespace Ui {
@@ -50,7 +52,7 @@ private slots:
   void closeAllTabs();
   void closeTab();
   void editFile(const QString& filename, int line);
-  void grepFiles(const QString& rootPath, const QStringList& files);
+  void grepFiles(const QString& rootPath, const PathStorePtr& paths, const FileIds& files);
   void newFindTab();
   void newGrepTab();
   void openLocation(const QString& s);
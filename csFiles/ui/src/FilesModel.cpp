@@ -31,48 +31,80 @@
 
 #include <algorithm>
 #include <iterator>
+#include <vector>
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QFileInfo>
+#include <QtCore/QTimer>
 
-#include "FilesModel.h"
-
-////// Private ///////////////////////////////////////////////////////////////
+#include "PathStore.h"
 
-namespace priv {
+#include "FilesModel.h"
 
-  template<typename DestT, typename SrcT>
-  void appendUnique(DestT& dest, const SrcT& src)
-  {
-    // (1) Copy source ///////////////////////////////////////////////////////
+////// Constants /////////////////////////////////////////////////////////////
 
-    std::copy(src.cbegin(), src.cend(), std::back_inserter(dest));
+// NOTE: Upper bound of rows moved by inserting a batch's runs one by one;
+//       beyond that, the batch is merged in one pass and the model is reset.
+constexpr qint64 kMaxInsertMoves = 4*1024*1024;
 
-    // (2) Sort sequence /////////////////////////////////////////////////////
+////// Private ///////////////////////////////////////////////////////////////
 
-    std::sort(dest.begin(), dest.end());
+namespace priv {
 
-    // (3) Make sequence unique //////////////////////////////////////////////
+  struct InsertRun {
+    int position{0}; // Row in the current list
+    int first{0};    // Index into the batch
+    int count{0};
+  };
 
-    typename DestT::iterator last = std::unique(dest.begin(), dest.end());
+  using InsertRuns = std::vector<InsertRun>;
 
-    // (4) Remove unnecessary items //////////////////////////////////////////
+  // NOTE: Both sequences are sorted; returns the runs of consecutive items
+  //       of 'batch' sharing the same insertion point in 'list'.
+  InsertRuns insertRuns(const PathStore *paths, const FileIds& list, const FileIds& batch)
+  {
+    InsertRuns result;
+
+    FileIds::const_iterator pos = list.cbegin();
+    for(std::size_t i = 0; i < batch.size(); i++) {
+      pos = std::lower_bound(pos, list.cend(), batch[i], [=](const FileId a, const FileId b) -> bool {
+        return paths->isLess(a, b);
+      });
+      const int position = static_cast<int>(pos - list.cbegin());
+      if( !result.empty()  &&  result.back().position == position ) {
+        result.back().count++;
+      } else {
+        result.push_back(InsertRun{position, static_cast<int>(i), 1});
+      }
+    }
+
+    return result;
+  }
 
-    dest.erase(last, dest.end());
+  // NOTE: Both sequences are sorted; removes all items of 'batch' already in 'list'.
+  void removeListed(const PathStore *paths, FileIds& batch, const FileIds& list)
+  {
+    FileIds result;
+    result.reserve(batch.size());
+    std::set_difference(batch.cbegin(), batch.cend(), list.cbegin(), list.cend(),
+                        std::back_inserter(result), [=](const FileId a, const FileId b) -> bool {
+      return paths->isLess(a, b);
+    });
+    batch.swap(result);
   }
 
-  template<typename SeqT>
-  void removeNoFiles(SeqT& seq)
+  void removeNoFiles(const PathStore *paths, FileIds& ids)
   {
     // (1) Remove all entries not qualifying as a file ///////////////////////
 
-    typename SeqT::iterator last = std::remove_if(seq.begin(), seq.end(),
-                                                  [](const QString& s) -> bool {
-      return !QFileInfo(s).isFile();
+    FileIds::iterator last = std::remove_if(ids.begin(), ids.end(),
+                                            [=](const FileId id) -> bool {
+      return !QFileInfo(paths->filePath(id)).isFile();
     });
 
     // (2) Remove unnecessary items //////////////////////////////////////////
 
-    seq.erase(last, seq.end());
+    ids.erase(last, ids.end());
   }
 
 } // namespace priv
@@ -81,11 +113,17 @@ namespace priv {
 
 FilesModel::FilesModel(QObject *parent)
   : QAbstractListModel(parent)
+  , _paths{PathStore::create()}
 {
+  _dirIcon  = _iconProvider.icon(QFileIconProvider::Folder);
+  _fileIcon = _iconProvider.icon(QFileIconProvider::File);
+
+  connect(&_kindsWatcher, &QFutureWatcher<Kinds>::finished, this, &FilesModel::storeKinds);
 }
 
 FilesModel::~FilesModel()
 {
+  _kindsWatcher.waitForFinished();
 }
 
 QVariant FilesModel::data(const QModelIndex& index, int role) const
@@ -93,16 +131,20 @@ QVariant FilesModel::data(const QModelIndex& index, int role) const
   if( !index.isValid() ) {
     return QVariant();
   }
+  const FileId id = _files[static_cast<std::size_t>(index.row())];
   if(        role == Qt::DisplayRole ) {
-    return !_rootPath.isEmpty()  &&  _files[index.row()].startsWith(_rootPath)
-        ? _root.relativeFilePath(_files[index.row()])
-        : _files[index.row()];
+    const QString relative = !_rootPath.isEmpty()
+        ? _paths->relativeFilePath(id, _rootId)
+        : QString();
+    return !relative.isEmpty()
+        ? relative
+        : _paths->filePath(id);
   } else if( role == Qt::DecorationRole ) {
-    return _iconProvider.icon(QFileInfo(_files[index.row()]));
+    return icon(id);
   } else if( role == Qt::EditRole ) {
-    return _files[index.row()];
+    return _paths->filePath(id);
   } else if( role == Qt::ToolTipRole ) {
-    return _files[index.row()];
+    return _paths->filePath(id);
   }
   return QVariant();
 }
@@ -123,7 +165,7 @@ QVariant FilesModel::headerData(int section, Qt::Orientation orientation, int ro
 int FilesModel::rowCount(const QModelIndex& parent) const
 {
   Q_UNUSED(parent);
-  return _files.size();
+  return static_cast<int>(_files.size());
 }
 
 void FilesModel::append(const QStringList& files)
@@ -131,19 +173,70 @@ void FilesModel::append(const QStringList& files)
   if( files.size() < 1 ) {
     return;
   }
-  beginResetModel();
-  priv::appendUnique(_files, files);
+  append(_paths->insert(files));
+}
+
+void FilesModel::append(const FileIds& files)
+{
+  if( files.empty() ) {
+    return;
+  }
+
+  // (1) Prepare sorted batch of new files ///////////////////////////////////
+
+  FileIds batch(files);
+  _paths->sort(batch);
+  priv::removeListed(_paths.get(), batch, _files);
   if( _listFilesOnly ) {
-    priv::removeNoFiles(_files);
+    priv::removeNoFiles(_paths.get(), batch);
+  }
+  if( batch.empty() ) {
+    return;
+  }
+
+  // (2) Insert runs back to front; inserted rows do not shift pending runs //
+
+  const priv::InsertRuns runs = priv::insertRuns(_paths.get(), _files, batch);
+
+  if( qint64(runs.size())*qint64(_files.size()) <= kMaxInsertMoves ) {
+    for(auto run = runs.crbegin(); run != runs.crend(); ++run) {
+      beginInsertRows(QModelIndex(), run->position, run->position + run->count - 1);
+      _files.insert(_files.begin() + run->position,
+                    batch.cbegin() + run->first, batch.cbegin() + run->first + run->count);
+      endInsertRows();
+    }
+    return;
   }
+
+  // (3) Merge batch in one pass /////////////////////////////////////////////
+
+  FileIds merged;
+  merged.reserve(_files.size() + batch.size());
+  std::merge(_files.cbegin(), _files.cend(), batch.cbegin(), batch.cend(),
+             std::back_inserter(merged), [=](const FileId a, const FileId b) -> bool {
+    return _paths->isLess(a, b);
+  });
+
+  beginResetModel();
+  _files.swap(merged);
   endResetModel();
 }
 
+// NOTE: The ids of another model are interned by path.
+void FilesModel::append(const PathStorePtr& paths, const FileIds& files)
+{
+  if( paths == _paths ) {
+    append(files);
+  } else if( paths ) {
+    append(paths->filePaths(files));
+  }
+}
+
 void FilesModel::clear()
 {
   beginResetModel();
   _files.clear();
-  _root = QDir();
+  _rootId = 0;
   _rootPath.clear();
   endResetModel();
 }
@@ -154,18 +247,37 @@ void FilesModel::clearRoot()
   refreshModel();
 }
 
+FileId FilesModel::fileId(const QModelIndex& index) const
+{
+  return _files[static_cast<std::size_t>(index.row())];
+}
+
+const FileIds& FilesModel::fileIds() const
+{
+  return _files;
+}
+
 QStringList FilesModel::files() const
 {
-  return _files.toList();
+  return _paths->filePaths(_files);
+}
+
+const PathStorePtr& FilesModel::paths() const
+{
+  return _paths;
 }
 
-void FilesModel::remove(const QStringList& files)
+void FilesModel::remove(FileIds files)
 {
+  std::sort(files.begin(), files.end());
+
   beginResetModel();
-  for(const QString& file : files) {
-    _files.removeAll(file);
-  }
-  if( _files.isEmpty() ) {
+  FileIds::iterator last = std::remove_if(_files.begin(), _files.end(),
+                                          [&](const FileId id) -> bool {
+    return std::binary_search(files.cbegin(), files.cend(), id);
+  });
+  _files.erase(last, _files.end());
+  if( _files.empty() ) {
     _rootPath.clear();
   }
   endResetModel();
@@ -181,8 +293,8 @@ bool FilesModel::setRoot(const QDir& root)
   if( !_rootPath.isEmpty() ) {
     return false;
   }
-  _root = root;
-  _rootPath = _root.absolutePath();
+  _rootPath = root.absolutePath();
+  _rootId = _paths->insert(_rootPath);
   refreshModel();
   return true;
 }
@@ -197,8 +309,95 @@ void FilesModel::setListFilesOnly(const bool on)
   _listFilesOnly = on;
 }
 
+////// private slots /////////////////////////////////////////////////////////
+
+void FilesModel::resolveKinds()
+{
+  if( _pendingKinds.empty()  ||  _kindsWatcher.isRunning() ) {
+    return;
+  }
+
+  FileIds ids;
+  ids.swap(_pendingKinds);
+
+  const PathStorePtr paths = _paths;
+  _kindsWatcher.setFuture(QtConcurrent::run([=]() -> Kinds {
+    Kinds result;
+    result.reserve(ids.size());
+    for(const FileId id : ids) {
+      result.emplace_back(id, QFileInfo(paths->filePath(id)).isDir()
+                          ? Directory
+                          : File);
+    }
+    return result;
+  }));
+}
+
+void FilesModel::storeKinds()
+{
+  const Kinds kinds = _kindsWatcher.result();
+
+  bool have_dir = false;
+  for(const std::pair<FileId,Kind>& k : kinds) {
+    _kinds[k.first] = k.second;
+    have_dir = have_dir  ||  k.second == Directory;
+  }
+
+  // NOTE: Only directories change their (presumed) icon!
+  if( have_dir  &&  rowCount() > 0 ) {
+    emit dataChanged(index(0), index(rowCount() - 1), QVector<int>{Qt::DecorationRole});
+  }
+
+  resolveKinds();
+}
+
 ////// private ///////////////////////////////////////////////////////////////
 
+// NOTE: Until its kind is resolved, an entry is presumed to be a file and
+//       is shown with the icon of its extension; the icon of an extension
+//       is looked up only once.
+QIcon FilesModel::icon(const FileId id) const
+{
+  if( kind(id) == Directory ) {
+    return _dirIcon;
+  }
+
+  const QString name = _paths->fileName(id);
+  const int dot = name.lastIndexOf(QLatin1Char('.'));
+  if( dot <= 0 ) {
+    return _fileIcon;
+  }
+
+  // NOTE: The MIME type is matched by name only; the file is never accessed.
+  const QString suffix = name.mid(dot + 1).toLower();
+  QHash<QString,QIcon>::const_iterator it = _icons.constFind(suffix);
+  if( it == _icons.constEnd() ) {
+    const QMimeType mime = _mimeDb.mimeTypeForFile(name, QMimeDatabase::MatchExtension);
+    const QIcon icon = QIcon::fromTheme(mime.iconName(),
+                                        QIcon::fromTheme(mime.genericIconName(), _fileIcon));
+    it = _icons.insert(suffix, icon);
+  }
+
+  return it.value();
+}
+
+FilesModel::Kind FilesModel::kind(const FileId id) const
+{
+  if( id >= _kinds.size() ) {
+    _kinds.resize(std::max<std::size_t>(std::size_t(id) + 1, _kinds.size()*2), Unknown);
+  }
+
+  if( _kinds[id] == Unknown ) {
+    _kinds[id] = Pending;
+    if( _pendingKinds.empty() ) {
+      QTimer::singleShot(0, const_cast<FilesModel*>(this), SLOT(resolveKinds()));
+    }
+    _pendingKinds.push_back(id);
+  }
+
+  return _kinds[id];
+}
+
 void FilesModel::refreshModel()
 {
   const QModelIndex from = index(0);
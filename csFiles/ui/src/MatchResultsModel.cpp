@@ -29,126 +29,275 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+
 #include <QtCreator/HighlightingItemDelegate.h>
 
 #include "MatchResultsModel.h"
 
-////// MatchResultsItem - public /////////////////////////////////////////////
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr int kFetchSize = 1024;
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  // NOTE: The internal ID of a file's index is 0; the internal ID
+  //       of a line's index is the row of its file plus 1.
+
+  constexpr quintptr kFileId = 0;
+
+  inline quintptr makeLineId(const int fileRow)
+  {
+    return static_cast<quintptr>(fileRow) + 1;
+  }
+
+  inline int toFileRow(const quintptr id)
+  {
+    return static_cast<int>(id - 1);
+  }
+
+  QVector<int> makeLengths(const MatchView& view)
+  {
+    QVector<int> result;
+    result.reserve(static_cast<int>(diff(view)));
+    for(const Match *m = view.first; m < view.second; ++m) {
+      result.push_back(m->second);
+    }
+    return result;
+  }
+
+  QVector<int> makeStarts(const MatchView& view)
+  {
+    QVector<int> result;
+    result.reserve(static_cast<int>(diff(view)));
+    for(const Match *m = view.first; m < view.second; ++m) {
+      result.push_back(m->first);
+    }
+    return result;
+  }
+
+} // namespace priv
 
-MatchResultsItem::MatchResultsItem(csAbstractTreeItem *parent)
-  : csAbstractTreeItem(parent)
+////// public ////////////////////////////////////////////////////////////////
+
+MatchResultsModel::MatchResultsModel(QObject *parent)
+  : QAbstractItemModel(parent)
 {
 }
 
-int MatchResultsItem::columnCount() const
+MatchResultsModel::~MatchResultsModel()
 {
+}
+
+bool MatchResultsModel::canFetchMore(const QModelIndex& parent) const
+{
+  if( !parent.isValid() ) {
+    return _fetchedFiles < static_cast<int>(_results.size());
+  }
+  return false;
+}
+
+int MatchResultsModel::columnCount(const QModelIndex& parent) const
+{
+  Q_UNUSED(parent);
   return 1;
 }
 
-////// MatchResultsRoot - public /////////////////////////////////////////////
+QVariant MatchResultsModel::data(const QModelIndex& index, int role) const
+{
+  using namespace QtCreator;
 
-MatchResultsRoot::MatchResultsRoot(const QString& rootPath)
-  : MatchResultsItem(nullptr)
-  , _rootPath(rootPath)
+  if( !index.isValid()  ||  index.column() != 0 ) {
+    return QVariant();
+  }
+
+  if( isFile(index) ) {
+    const MatchResult& result = *_results[index.row()];
+    if(        role == Qt::DisplayRole ) {
+      return displayFilename(result.filename());
+    } else if( role == Qt::ToolTipRole ) {
+      return result.filename();
+    }
+    return QVariant();
+  }
+
+  const MatchResult& result = *_results[fileRow(index)];
+  if(        role == Qt::DisplayRole ) {
+    return result.lineText(index.row());
+  } else if( role == int(HighlightingItemRole::LineNumber) ) {
+    return result.lineNumber(index.row());
+  } else if( result.lineIsContext(index.row()) ) {
+    // NOTE: Context lines are shown without any highlighting!
+    if( role == Qt::ForegroundRole ) {
+      return QColor(Qt::gray);
+    }
+  } else if( role == int(HighlightingItemRole::StartColumn) ) {
+    return QVariant::fromValue(priv::makeStarts(result.lineMatches(index.row())));
+  } else if( role == int(HighlightingItemRole::Length) ) {
+    return QVariant::fromValue(priv::makeLengths(result.lineMatches(index.row())));
+  } else if( role == int(HighlightingItemRole::Foreground) ) {
+    return QColor(Qt::black);
+  } else if( role == int(HighlightingItemRole::Background) ) {
+    return QColor(Qt::yellow);
+  }
+
+  return QVariant();
+}
+
+void MatchResultsModel::fetchMore(const QModelIndex& parent)
 {
-  if( !_rootPath.isEmpty() ) {
-    _root.setPath(_rootPath);
+  if( !canFetchMore(parent) ) {
+    return;
   }
+
+  const int available = static_cast<int>(_results.size());
+
+  const int count = std::min<int>(available - _fetchedFiles, kFetchSize);
+
+  beginInsertRows(parent, _fetchedFiles, _fetchedFiles + count - 1);
+  _fetchedFiles += count;
+  endInsertRows();
 }
 
-QVariant MatchResultsRoot::data(int column, int role) const
+bool MatchResultsModel::hasChildren(const QModelIndex& parent) const
 {
-  if( role == Qt::DisplayRole ) {
-    if( column == 0 ) {
-      return QStringLiteral("Results");
-    }
+  if(        !parent.isValid() ) {
+    return !_results.empty();
+  } else if( isFile(parent) ) {
+    return _results[parent.row()]->lineCount() > 0;
+  }
+  return false;
+}
+
+QVariant MatchResultsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if( section == 0  &&  orientation == Qt::Horizontal  &&  role == Qt::DisplayRole ) {
+    return tr("Results");
   }
   return QVariant();
 }
 
-QString MatchResultsRoot::displayFilename(const QString& filename) const
+QModelIndex MatchResultsModel::index(int row, int column, const QModelIndex& parent) const
 {
-  return !_rootPath.isEmpty()  &&  filename.startsWith(_rootPath)
-      ? _root.relativeFilePath(filename)
-      : filename;
+  if( !hasIndex(row, column, parent) ) {
+    return QModelIndex();
+  }
+  if(        !parent.isValid() ) {
+    return createIndex(row, column, priv::kFileId);
+  } else if( isFile(parent) ) {
+    return createIndex(row, column, priv::makeLineId(parent.row()));
+  }
+  return QModelIndex();
 }
 
-QStringList MatchResultsRoot::files() const
+QModelIndex MatchResultsModel::parent(const QModelIndex& index) const
 {
-  QStringList result;
-  for(int i = 0; i < rowCount(); i++) {
-    csAbstractTreeItem *item = childItem(i);
-    MatchResultsFile   *file = dynamic_cast<MatchResultsFile*>(item);
-    if( file == nullptr ) {
-      continue;
-    }
-    result.push_back(file->filename());
+  if( !isLine(index) ) {
+    return QModelIndex();
   }
-  return result;
+  return createIndex(fileRow(index), 0, priv::kFileId);
 }
 
-QString MatchResultsRoot::rootPath() const
+int MatchResultsModel::rowCount(const QModelIndex& parent) const
 {
-  return _rootPath;
+  if(        !parent.isValid() ) {
+    return _fetchedFiles;
+  } else if( isFile(parent)  &&  parent.column() == 0 ) {
+    return _results[parent.row()]->lineCount();
+  }
+  return 0;
 }
 
-////// MatchRestulsFile - public /////////////////////////////////////////////
+void MatchResultsModel::clear()
+{
+  setResults(MatchResults(), QString());
+}
 
-MatchResultsFile::MatchResultsFile(const QString& filename, MatchResultsRoot *parent)
-  : MatchResultsItem(parent)
-  , _filename(filename)
+QString MatchResultsModel::displayFilename(const QString& filename) const
 {
+  return !_rootPath.isEmpty()  &&  filename.startsWith(_rootPath)
+      ? _root.relativeFilePath(filename)
+      : filename;
 }
 
-QVariant MatchResultsFile::data(int column, int role) const
+QString MatchResultsModel::filename(const QModelIndex& index) const
 {
-  if( column == 0 ) {
-    if(        role == Qt::DisplayRole ) {
-      return dynamic_cast<const MatchResultsRoot*>(parentItem())->displayFilename(_filename);
-    } else if( role == Qt::ToolTipRole ) {
-      return _filename;
-    }
+  if( !index.isValid() ) {
+    return QString();
   }
-  return QVariant();
+  return _results[isFile(index) ? index.row() : fileRow(index)]->filename();
 }
 
-QString MatchResultsFile::filename() const
+FileIds MatchResultsModel::fileIds() const
 {
-  return _filename;
+  FileIds result;
+  result.reserve(_results.size());
+  for(const MatchResultPtr& r : _results) {
+    result.push_back(r->fileId);
+  }
+  return result;
 }
 
-////// MatchResultsLine - public /////////////////////////////////////////////
+int MatchResultsModel::lineNumber(const QModelIndex& index) const
+{
+  if( !isLine(index) ) {
+    return 0;
+  }
+  return _results[fileRow(index)]->lineNumber(index.row());
+}
 
-MatchResultsLine::MatchResultsLine(const MatchedLine& line, MatchResultsFile *parent)
-  : MatchResultsItem(parent)
-  , _line(line)
+QString MatchResultsModel::rootPath() const
 {
+  return _rootPath;
 }
 
-QVariant MatchResultsLine::data(int column, int role) const
+void MatchResultsModel::setResults(MatchResults results, const QString& rootPath)
 {
-  using namespace QtCreator;
+  beginResetModel();
 
-  if( column == 0 ) {
-    if(        role == Qt::DisplayRole ) {
-      return _line.text;
-    } else if( role == int(HighlightingItemRole::LineNumber) ) {
-      return _line.number;
-    } else if( role == int(HighlightingItemRole::StartColumn) ) {
-      return QVariant::fromValue(_line.start);
-    } else if( role == int(HighlightingItemRole::Length) ) {
-      return QVariant::fromValue(_line.length);
-    } else if( role == int(HighlightingItemRole::Foreground) ) {
-      return QColor(Qt::black);
-    } else if( role == int(HighlightingItemRole::Background) ) {
-      return QColor(Qt::yellow);
+  _results.clear();
+  _results.reserve(static_cast<std::size_t>(results.size()));
+  for(MatchResultPtr& r : results) {
+    if( r  &&  !r->isEmpty() ) {
+      _results.push_back(std::move(r));
     }
   }
+  // NOTE: All results of one grep refer to the same PathStore!
+  const PathStore *paths = !_results.empty()
+      ? _results.front()->paths
+      : nullptr;
+  if( paths != nullptr ) {
+    std::sort(_results.begin(), _results.end(),
+              [=](const MatchResultPtr& a, const MatchResultPtr& b) -> bool {
+      return paths->isLess(a->fileId, b->fileId);
+    });
+  }
 
-  return QVariant();
+  _fetchedFiles = 0;
+
+  _rootPath = rootPath;
+  _root = !_rootPath.isEmpty()
+      ? QDir(_rootPath)
+      : QDir();
+
+  endResetModel();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+int MatchResultsModel::fileRow(const QModelIndex& index) const
+{
+  return priv::toFileRow(index.internalId());
+}
+
+bool MatchResultsModel::isFile(const QModelIndex& index) const
+{
+  return index.isValid()  &&  index.internalId() == priv::kFileId;
 }
 
-int MatchResultsLine::number() const
+bool MatchResultsModel::isLine(const QModelIndex& index) const
 {
-  return _line.number;
+  return index.isValid()  &&  index.internalId() != priv::kFileId;
 }
@@ -49,12 +49,15 @@ namespace Settings {
   namespace find {
 
     Presets extensions;
+    QString watchedRoot;
 
   } // namespace find
 
   namespace grep {
 
+    QString bloomCache;
     bool copyLocationDisplayName{false};
+    int corpusCacheSize{256};
 
   } // namespace grep
 
@@ -74,6 +77,10 @@ namespace Settings {
 
     // find //////////////////////////////////////////////////////////////////
 
+    settings.beginGroup(QStringLiteral("find"));
+    find::watchedRoot = settings.value(QStringLiteral("watched_root"), find::watchedRoot).toString();
+    settings.endGroup();
+
     settings.beginGroup(QStringLiteral("find_extensions"));
     int i = 0;
     while( true ) {
@@ -93,7 +100,9 @@ namespace Settings {
     // grep //////////////////////////////////////////////////////////////////
 
     settings.beginGroup(QStringLiteral("grep"));
+    grep::bloomCache = settings.value(QStringLiteral("bloom_cache"), grep::bloomCache).toString();
     grep::copyLocationDisplayName = settings.value(QStringLiteral("copy_location_displayname"), grep::copyLocationDisplayName).toBool();
+    grep::corpusCacheSize = settings.value(QStringLiteral("corpus_cache_size"), grep::corpusCacheSize).toInt();
     settings.endGroup();
   }
 
@@ -112,6 +121,10 @@ namespace Settings {
 
     // find //////////////////////////////////////////////////////////////////
 
+    settings.beginGroup(QStringLiteral("find"));
+    settings.setValue(QStringLiteral("watched_root"), find::watchedRoot);
+    settings.endGroup();
+
     if( !find::extensions.isEmpty() ) {
       settings.beginGroup(QStringLiteral("find_extensions"));
       for(int i = 0; i < find::extensions.size(); i++) {
@@ -124,7 +137,9 @@ namespace Settings {
     // grep //////////////////////////////////////////////////////////////////
 
     settings.beginGroup(QStringLiteral("grep"));
+    settings.setValue(QStringLiteral("bloom_cache"), grep::bloomCache);
     settings.setValue(QStringLiteral("copy_location_displayname"), grep::copyLocationDisplayName);
+    settings.setValue(QStringLiteral("corpus_cache_size"), grep::corpusCacheSize);
     settings.endGroup();
 
     //////////////////////////////////////////////////////////////////////////
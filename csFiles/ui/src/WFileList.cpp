@@ -119,11 +119,21 @@ int WFileList::count() const
   return _model->rowCount();
 }
 
+const FileIds& WFileList::fileIds() const
+{
+  return _model->fileIds();
+}
+
 QStringList WFileList::files() const
 {
   return _model->files();
 }
 
+const PathStorePtr& WFileList::paths() const
+{
+  return _model->paths();
+}
+
 QString WFileList::rootPath() const
 {
   return _model->rootPath();
@@ -149,6 +159,19 @@ void WFileList::appendFiles(const QString& rootPath, const QStringList& files)
   appendFiles(QDir(rootPath), files);
 }
 
+void WFileList::appendFiles(const PathStorePtr& paths, const FileIds& files)
+{
+  _model->append(paths, files);
+}
+
+void WFileList::appendFiles(const QString& rootPath, const PathStorePtr& paths, const FileIds& files)
+{
+  appendFiles(paths, files);
+  if( autoRoot() ) {
+    _model->setRoot(QDir(rootPath));
+  }
+}
+
 void WFileList::clearList()
 {
   _model->clear();
@@ -213,9 +236,10 @@ void WFileList::onRemove()
 {
   const QModelIndexList selection = view()->selectionModel()->selectedIndexes();
 
-  QStringList files;
+  FileIds files;
+  files.reserve(static_cast<FileIds::size_type>(selection.size()));
   for(const QModelIndex& index : selection) {
-    files.push_back(_model->data(index, Qt::EditRole).toString());
+    files.push_back(_model->fileId(index));
   }
 
   _model->remove(files);
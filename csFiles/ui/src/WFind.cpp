@@ -29,8 +29,11 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <QtCore/QDirIterator>
-#include <QtCore/QRegExp>
+#include <memory>
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QDateTime>
+#include <QtCore/QItemSelectionModel>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMenu>
 
@@ -42,6 +45,9 @@
 #include "ExtensionFilter.h"
 #include "FilenameFilter.h"
 #include "FilesModel.h"
+#include "FindJob.h"
+#include "LiveIndex.h"
+#include "MetadataFilter.h"
 #include "PathFilter.h"
 #include "PatternList.h"
 #include "Settings.h"
@@ -54,19 +60,6 @@ constexpr int kMaxTabLabel = 32;
 
 namespace priv {
 
-  QDir::Filters makeDirFilters(const Ui::WFind *ui)
-  {
-    const bool no_filter = !ui->dirsCheck->isChecked()  &&  !ui->filesCheck->isChecked();
-
-    QDir::Filters result{0};
-    result.setFlag(QDir::NoDot, true);
-    result.setFlag(QDir::NoDotDot, true);
-    result.setFlag(QDir::Dirs,  no_filter  ||  ui->dirsCheck->isChecked());
-    result.setFlag(QDir::Files, no_filter  ||  ui->filesCheck->isChecked());
-
-    return result;
-  }
-
   IFindFilterPtr makeExtensionFilter(Ui::WFind *ui, const bool complete)
   {
     ui->extensionFilterEdit->setText(cleanPatternList(ui->extensionFilterEdit->text()));
@@ -78,15 +71,31 @@ namespace priv {
     return FilenameFilter::create(ui->filenameFilterEdit->text(), ui->filenameRejectCheck->isChecked());
   }
 
-  QDirIterator::IteratorFlags makeIterFlags(const Ui::WFind *ui)
+  FindFlags makeFindFlags(const Ui::WFind *ui)
   {
-    QDirIterator::IteratorFlags result = QDirIterator::NoIteratorFlags;
-    result.setFlag(QDirIterator::FollowSymlinks, ui->followSymLinkCheck->isChecked());
-    result.setFlag(QDirIterator::Subdirectories, ui->subDirsCheck->isChecked());
+    FindFlags result{FindFlag::NoFlags};
+    result.set(FindFlag::Directories, ui->dirsCheck->isChecked());
+    result.set(FindFlag::Files, ui->filesCheck->isChecked());
+    result.set(FindFlag::FollowSymlinks, ui->followSymLinkCheck->isChecked());
+    result.set(FindFlag::IgnoreFiles, ui->ignoreFilesCheck->isChecked());
+    result.set(FindFlag::SameFileSystem, ui->sameFileSystemCheck->isChecked());
+    result.set(FindFlag::Subdirectories, ui->subDirsCheck->isChecked());
 
     return result;
   }
 
+  IFindFilterPtr makeMetadataFilter(const Ui::WFind *ui)
+  {
+    MetadataCriteria criteria;
+    if( ui->minSizeSpin->value() > 0 ) {
+      criteria.minSize = int64_t(ui->minSizeSpin->value())*1024;
+    }
+    if( ui->modifiedSpin->value() > 0 ) {
+      criteria.modifiedAfter = QDateTime::currentMSecsSinceEpoch() - int64_t(ui->modifiedSpin->value())*86400000;
+    }
+    return MetadataFilter::create(criteria);
+  }
+
   IFindFilterPtr makePathFilter(Ui::WFind *ui)
   {
     ui->pathFilterEdit->setText(cleanPatternList(ui->pathFilterEdit->text()));
@@ -103,6 +112,8 @@ WFind::WFind(QWidget *parent, Qt::WindowFlags f)
 {
   ui->setupUi(this);
 
+  qRegisterMetaType<FileIds>();
+
   // User Interface //////////////////////////////////////////////////////////
 
   ui->resultsView->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -136,11 +147,20 @@ WFind::WFind(QWidget *parent, Qt::WindowFlags f)
   connect(ui->browseButton, &QPushButton::clicked, this, &WFind::browse);
   connect(ui->dirEdit, &QLineEdit::textChanged, this, &WFind::setTabLabel);
   connect(ui->findButton, &QPushButton::clicked, this, &WFind::executeFind);
+  connect(&_findWatcher, &QFutureWatcher<void>::finished, this, &WFind::findFinished);
+  connect(this, &WFind::resultsFound, this, [this](const FileIds& files, const quint64 generation) -> void {
+    // NOTE: Batches of a cancelled find may still be queued; drop them.
+    if( generation == _findGeneration ) {
+      _resultsModel->append(files);
+    }
+  }, Qt::QueuedConnection);
   connect(ui->resultsView, &QListView::customContextMenuRequested, this, &WFind::showResultsContextMenu);
 }
 
 WFind::~WFind()
 {
+  _cancelFind = true;
+  _findWatcher.waitForFinished();
   delete ui;
 }
 
@@ -164,11 +184,23 @@ void WFind::browse()
 
 void WFind::clearResults()
 {
-  _resultsModel->clear();
+  stopFind();
+
+  // NOTE: A new model releases the paths interned by the previous find.
+  FilesModel *model = new FilesModel(this);
+  QItemSelectionModel *selection = ui->resultsView->selectionModel();
+  ui->resultsView->setModel(model);
+  delete selection;
+  delete _resultsModel;
+  _resultsModel = model;
 }
 
 void WFind::executeFind()
 {
+  if( _findWatcher.isRunning() ) {
+    stopFind();
+    return;
+  }
   if( ui->dirEdit->text().isEmpty() ) {
     return;
   }
@@ -178,33 +210,34 @@ void WFind::executeFind()
   const QDir rootDir(ui->dirEdit->text());
   _resultsModel->setRoot(rootDir);
 
-  const IFindFilterPtr  extFilter = priv::makeExtensionFilter(ui, _completeSuffixAction->isChecked());
-  const IFindFilterPtr fileFilter = priv::makeFilenameFilter(ui);
-  const IFindFilterPtr pathFitler = priv::makePathFilter(ui);
-
-  const QDir::Filters              dirFilters = priv::makeDirFilters(ui);
-  const QDirIterator::IteratorFlags iterFlags = priv::makeIterFlags(ui);
-
-  QDirIterator iter(rootDir.absolutePath(), dirFilters, iterFlags);
-
-  QStringList results;
-  while( iter.hasNext() ) {
-    iter.next();
-    const QFileInfo info = iter.fileInfo();
-
-    if( pathFitler->filtered(info) ) {
-      continue;
-    }
-    if( extFilter->filtered(info) ) {
-      continue;
-    }
-    if( fileFilter->filtered(info) ) {
-      continue;
-    }
+  // NOTE: FindJob is move-only; the shared pointer carries it into the task.
+  std::shared_ptr<FindJob> job =
+      std::make_shared<FindJob>(rootDir.absolutePath(), priv::makeFindFlags(ui));
+  job->filters.push_back(priv::makePathFilter(ui));
+  job->filters.push_back(priv::makeExtensionFilter(ui, _completeSuffixAction->isChecked()));
+  job->filters.push_back(priv::makeFilenameFilter(ui));
+  job->filters.push_back(priv::makeMetadataFilter(ui));
+  job->cancel = &_cancelFind;
+  job->index = LiveIndex::global();
+
+  _cancelFind = false;
+  const quint64 generation = ++_findGeneration;
+  ui->findButton->setText(tr("Stop"));
+
+  // NOTE: Batches are interned by the worker threads, then queued to the model
+  //       and inserted while the find is running.
+  const PathStorePtr paths = _resultsModel->paths();
+  _findWatcher.setFuture(QtConcurrent::run([this,job,generation,paths]() -> void {
+    ::executeFind(*job, [this,generation,paths](const QStringList& batch) -> void {
+      emit resultsFound(paths->insert(batch), generation);
+    });
+  }));
+}
 
-    results.push_back(info.absoluteFilePath());
-  }
-  _resultsModel->append(results);
+void WFind::findFinished()
+{
+  ui->findButton->setText(tr("Find"));
+  ui->findButton->setEnabled(true);
 }
 
 void WFind::setExtension()
@@ -244,6 +277,9 @@ void WFind::showResultsContextMenu(const QPoint& p)
   QAction  *openAction = menu.addAction(tr("Open location"));
   menu.addSeparator();
   QAction *clearAction = menu.addAction(tr("Clear results"));
+  menu.addSeparator();
+  QAction  *stopAction = menu.addAction(tr("Stop find"));
+  stopAction->setEnabled(_findWatcher.isRunning());
 
   QAction *choice = menu.exec(csMapToGlobal(ui->resultsView, p));
   if(        choice == nullptr ) {
@@ -255,7 +291,7 @@ void WFind::showResultsContextMenu(const QPoint& p)
     emit editFileRequested(filename, 1);
 
   } else if( choice == grepAction ) {
-    emit grepRequested(_resultsModel->rootPath(), _resultsModel->files());
+    emit grepRequested(_resultsModel->rootPath(), _resultsModel->paths(), _resultsModel->fileIds());
 
   } else if( choice == openAction ) {
     const QModelIndex index = ui->resultsView->indexAt(p);
@@ -265,5 +301,20 @@ void WFind::showResultsContextMenu(const QPoint& p)
   } else if( choice == clearAction ) {
     clearResults();
 
+  } else if( choice == stopAction ) {
+    stopFind();
+
+  }
+}
+
+void WFind::stopFind()
+{
+  if( !_findWatcher.isRunning() ) {
+    return;
   }
+  // NOTE: The find winds down in the background; its pending batches are
+  //       discarded by the generation check and findFinished() resets the UI.
+  _cancelFind = true;
+  ++_findGeneration;
+  ui->findButton->setEnabled(false);
 }
@@ -29,17 +29,19 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
-#include <algorithm>
-
 #include <QtConcurrent/QtConcurrentMap>
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QMessageBox>
 
-#include <csQt/csTreeModel.h>
 #include <csQt/csQtUtil.h>
+#include <csUtil/csILogger.h>
 #include <csUtil/csWProgressLogger.h>
 
+#include "BloomCache.h"
+#include "CorpusCache.h"
+#include "MatchLog.h"
 #include "MatchResultsModel.h"
+#include "ResultCache.h"
 #include "ResultsProxyDelegate.h"
 #include "Settings.h"
 
@@ -50,11 +52,27 @@
 
 namespace priv {
 
-  MatchJob makeJob(const QString& filename, const csILogger *logger, const IMatcherPtr& matcher)
+  // NOTE: The contents of files are shared by all views.
+  CorpusCache *corpusCache()
   {
-    MatchJob job{filename};
+    static CorpusCache cache(qint64(Settings::grep::corpusCacheSize)*1024*1024);
+    return Settings::grep::corpusCacheSize > 0
+        ? &cache
+        : nullptr;
+  }
 
-    job.logger = logger;
+  MatchJob makeJob(const PathStore *paths, const FileId fileId, MatchLog *log,
+                   BloomCache *bloom, CorpusCache *corpus, ResultCache *results,
+                   const IMatcherPtr& matcher, const Ui::WGrep *ui)
+  {
+    MatchJob job{paths, fileId};
+
+    job.contextAfter  = ui->contextAfterSpin->value();
+    job.contextBefore = ui->contextBeforeSpin->value();
+    job.log = log;
+    job.bloom = bloom;
+    job.corpus = corpus;
+    job.results = results;
     if( matcher ) {
       job.matcher = matcher->clone();
     }
@@ -62,22 +80,15 @@ namespace priv {
     return job;
   }
 
-  using Location = QPair<const MatchResultsFile*,const MatchResultsLine*>;
-
-  Location makeLocation(const QModelIndex& index)
+  MatchLog::Sink makeLogSink(const csILogger *logger)
   {
-    if( !index.isValid() ) {
-      return Location{nullptr, nullptr};
-    }
-
-    const csAbstractTreeItem *item = csTreeItem(index);
-
-    const MatchResultsLine *line = dynamic_cast<const MatchResultsLine*>(item);
-    const MatchResultsFile *file = line != nullptr
-        ? dynamic_cast<const MatchResultsFile*>(line->parentItem())
-        : dynamic_cast<const MatchResultsFile*>(item);
-
-    return Location{file, line};
+    return [=](const MatchLog::Level level, const std::string& message) -> void {
+      if( level == MatchLog::Level::Error ) {
+        logger->logError(message);
+      } else {
+        logger->logWarning(message);
+      }
+    };
   }
 
   IMatcherPtr makeMatcher(const Ui::WGrep *ui)
@@ -105,48 +116,27 @@ namespace priv {
     return result;
   }
 
-  void prepareResults(MatchResults& results)
-  {
-    // (1.1) Remove results without any matched lines ////////////////////////
-
-    MatchResults::iterator last =
-        std::remove_if(results.begin(), results.end(),
-                       [](const MatchResult& r) -> bool {
-      return r.isEmpty();
-    });
-
-    // (1.2) Remove range of "empty" results /////////////////////////////////
-
-    results.erase(last, results.end());
-
-    // (2) Sort results by filename //////////////////////////////////////////
-
-    std::sort(results.begin(), results.end());
-
-    // (3) Sort lines of each result /////////////////////////////////////////
-
-    std::for_each(results.begin(), results.end(), [](MatchResult& r) -> void {
-      std::sort(r.lines.begin(), r.lines.end());
-    });
-  }
-
-  MatchResultsRoot *makeResults(MatchResults results, const QString& rootPath)
+  QString makeSummary(const MatchLog::Statistics& stats, const CorpusCache::Statistics& corpus)
   {
-    prepareResults(results);
-
-    MatchResultsRoot *root = new MatchResultsRoot(rootPath);
-
-    for(const MatchResult& result : results) {
-      MatchResultsFile *file = new MatchResultsFile(result.filename, root);
-      root->appendChild(file);
-
-      for(const MatchedLine& mline : result.lines) {
-        MatchResultsLine *line = new MatchResultsLine(mline, file);
-        file->appendChild(line);
-      }
+    QString result = QStringLiteral("Results - %1 files, %2 MiB")
+        .arg(qulonglong(stats.files))
+        .arg(double(stats.bytes)/1024.0/1024.0, 0, 'f', 1);
+    if( stats.warnings > 0  ||  stats.errors > 0 ) {
+      result += QStringLiteral(", %1 warnings, %2 errors")
+          .arg(qulonglong(stats.warnings))
+          .arg(qulonglong(stats.errors));
     }
-
-    return root;
+    if( stats.reused > 0 ) {
+      result += QStringLiteral(", %1 unchanged").arg(qulonglong(stats.reused));
+    }
+    if( corpus.hits > 0 ) {
+      result += QStringLiteral(", %1% from memory")
+          .arg(100.0*double(corpus.hits)/double(corpus.hits + corpus.misses), 0, 'f', 0);
+    }
+    if( stats.suppressed > 0 ) {
+      result += QStringLiteral(" (%1 messages suppressed)").arg(qulonglong(stats.suppressed));
+    }
+    return result;
   }
 
 } // namespace priv
@@ -156,6 +146,7 @@ namespace priv {
 WGrep::WGrep(QWidget *parent, Qt::WindowFlags f)
   : ITabWidget(parent, f)
   , ui{new Ui::WGrep}
+  , _resultCache{new ResultCache()}
 {
   ui->setupUi(this);
 
@@ -170,8 +161,9 @@ WGrep::WGrep(QWidget *parent, Qt::WindowFlags f)
 
   // Results Model ///////////////////////////////////////////////////////////
 
-  _resultsModel = new csTreeModel(new MatchResultsRoot(QString()), this);
+  _resultsModel = new MatchResultsModel(this);
   ui->resultsView->setModel(_resultsModel);
+  ui->resultsView->setUniformRowHeights(true);
 
   // Signals & Slots /////////////////////////////////////////////////////////
 
@@ -182,6 +174,7 @@ WGrep::WGrep(QWidget *parent, Qt::WindowFlags f)
 
 WGrep::~WGrep()
 {
+  delete _resultCache;
   delete ui;
 }
 
@@ -207,26 +200,38 @@ void WGrep::appendFiles(const QString& rootPath, const QStringList& files)
   ui->filesWidget->appendFiles(rootPath, files);
 }
 
+void WGrep::appendFiles(const PathStorePtr& paths, const FileIds& files)
+{
+  ui->filesWidget->appendFiles(paths, files);
+}
+
+void WGrep::appendFiles(const QString& rootPath, const PathStorePtr& paths, const FileIds& files)
+{
+  ui->filesWidget->appendFiles(rootPath, paths, files);
+}
+
 ////// private slots /////////////////////////////////////////////////////////
 
 void WGrep::clearResults()
 {
-  _resultsModel->setRoot(new MatchResultsRoot(QString()));
+  _resultsModel->clear();
+  ui->groupBox_4->setTitle(tr("Results"));
 }
 
 void WGrep::copyLine(const QModelIndex& index)
 {
-  auto [file, line] = priv::makeLocation(index);
-  if( file == nullptr ) {
+  if( !index.isValid() ) {
     return;
   }
 
   const QString filename = Settings::grep::copyLocationDisplayName
-      ? file->data(0, Qt::DisplayRole).toString()
-      : file->filename();
+      ? _resultsModel->displayFilename(_resultsModel->filename(index))
+      : _resultsModel->filename(index);
+
+  const int lineno = _resultsModel->lineNumber(index);
 
-  const QString text = line != nullptr
-      ? QStringLiteral("%1:%2").arg(filename).arg(line->number())
+  const QString text = lineno > 0
+      ? QStringLiteral("%1:%2").arg(filename).arg(lineno)
       : filename;
 
   csSetClipboardText(text);
@@ -234,16 +239,12 @@ void WGrep::copyLine(const QModelIndex& index)
 
 void WGrep::editFile(const QModelIndex& index)
 {
-  auto [file, line] = priv::makeLocation(index);
-  if( file == nullptr ) {
+  if( !index.isValid() ) {
     return;
   }
 
-  if( line != nullptr ) {
-    emit editFileRequested(file->filename(), line->number());
-  } else {
-    emit editFileRequested(file->filename(), 1);
-  }
+  emit editFileRequested(_resultsModel->filename(index),
+                         qMax<int>(1, _resultsModel->lineNumber(index)));
 }
 
 void WGrep::executeGrep()
@@ -259,32 +260,52 @@ void WGrep::executeGrep()
   csWProgressLogger dialog(this);
   dialog.setWindowTitle(tr("Executing grep..."));
 
+  MatchLog log(priv::makeLogSink(dialog.logger()));
+
+  const BloomCachePtr bloom =
+      BloomCache::create(Settings::grep::bloomCache, requiredLiterals(matcher->pattern(), matcher->flags()));
+
+  CorpusCache *corpus = priv::corpusCache();
+  const CorpusCache::Statistics corpusBefore = corpus != nullptr
+      ? corpus->statistics()
+      : CorpusCache::Statistics();
+
   MatchJobs jobs;
-  const QStringList files = ui->filesWidget->files();
-  for(const QString& filename : files) {
-    jobs.push_back(priv::makeJob(filename, dialog.logger(), matcher));
+  const PathStore *paths = ui->filesWidget->paths().get();
+  const FileIds& files = ui->filesWidget->fileIds();
+  jobs.reserve(files.size());
+  for(const FileId fileId : files) {
+    jobs.push_back(priv::makeJob(paths, fileId, &log, bloom.get(), corpus, _resultCache, matcher, ui));
   }
 
-  QFutureWatcher<MatchResult> watcher;
+  QFutureWatcher<MatchResultPtr> watcher;
   dialog.setFutureWatcher(&watcher);
 
-  QFuture<MatchResult> future = QtConcurrent::mapped(jobs, executeJob);
+  // NOTE: Mapping iterators avoids a copy of 'jobs' (and their matchers)!
+  QFuture<MatchResultPtr> future = QtConcurrent::mapped(jobs.cbegin(), jobs.cend(), executeJob);
   watcher.setFuture(future);
 
   dialog.exec();
   future.waitForFinished();
 
-  _resultsModel->setRoot(priv::makeResults(future.results(), ui->filesWidget->rootPath()));
+  _resultsModel->setResults(future.results(), ui->filesWidget->rootPath());
+  // NOTE: Only hits & misses of this grep are summarized.
+  CorpusCache::Statistics corpusStats = corpus != nullptr
+      ? corpus->statistics()
+      : CorpusCache::Statistics();
+  corpusStats.hits   -= corpusBefore.hits;
+  corpusStats.misses -= corpusBefore.misses;
+
+  ui->groupBox_4->setTitle(priv::makeSummary(log.statistics(), corpusStats));
 }
 
 void WGrep::openLocation(const QModelIndex& index)
 {
-  auto [file, line] = priv::makeLocation(index);
-  if( file == nullptr ) {
+  if( !index.isValid() ) {
     return;
   }
 
-  emit openLocationRequested(file->filename());
+  emit openLocationRequested(_resultsModel->filename(index));
 }
 
 void WGrep::setTabLabel(const QString& text)
@@ -322,12 +343,7 @@ void WGrep::showContextMenu(const QPoint& p)
     copyLine(ui->resultsView->indexAt(p));
 
   } else if( choice == grepAction ) {
-    MatchResultsRoot *root = dynamic_cast<MatchResultsRoot*>(_resultsModel->root());
-    if( root == nullptr ) {
-      return;
-    }
-
-    emit grepRequested(root->rootPath(), root->files());
+    emit grepRequested(_resultsModel->rootPath(), ui->filesWidget->paths(), _resultsModel->fileIds());
 
   } else if( choice == openAction ) {
     openLocation(ui->resultsView->indexAt(p));
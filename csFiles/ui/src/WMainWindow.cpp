@@ -102,9 +102,9 @@ void WMainWindow::editFile(const QString& filename, int line)
   QProcess::startDetached(cmd);
 }
 
-void WMainWindow::grepFiles(const QString& rootPath, const QStringList& files)
+void WMainWindow::grepFiles(const QString& rootPath, const PathStorePtr& paths, const FileIds& files)
 {
-  if( files.isEmpty() ) {
+  if( files.empty() ) {
     return;
   }
 
@@ -115,9 +115,9 @@ void WMainWindow::grepFiles(const QString& rootPath, const QStringList& files)
   }
 
   if( rootPath.isEmpty() ) {
-    grep->appendFiles(files);
+    grep->appendFiles(paths, files);
   } else {
-    grep->appendFiles(rootPath, files);
+    grep->appendFiles(rootPath, paths, files);
   }
 }
 
@@ -35,6 +35,7 @@
 #include <QtCore/QDir>
 #include <QtWidgets/QApplication>
 
+#include "LiveIndex.h"
 #include "Settings.h"
 #include "WMainWindow.h"
 
@@ -46,12 +47,18 @@ int main(int argc, char **argv)
 
   Settings::load();
 
+  if( !Settings::find::watchedRoot.isEmpty() ) {
+    LiveIndex::global()->watch(QDir(Settings::find::watchedRoot).absolutePath().toStdString());
+  }
+
   WMainWindow *w = new WMainWindow;
   w->show();
 
   const int result = app.exec();
   delete w;
 
+  LiveIndex::global()->stop();
+
   Settings::save();
 
   return result;